@@ -6,8 +6,8 @@
 #include <Eigen/Core>
 #include <Eigen/Householder>
 #include <Eigen/SparseCore>
+#include <Euclid/Descriptor/DistanceMatrix.h>
 #include <Euclid/Descriptor/HKS.h>
-#include <Euclid/Descriptor/Histogram.h>
 #include <Euclid/IO/OffIO.h>
 #include <Euclid/IO/PlyIO.h>
 #include <Euclid/MeshUtil/MeshHelpers.h>
@@ -75,10 +75,12 @@ void hks_to_color(const std::vector<double>& positions,
                   const Arr& signatures,
                   int vidx)
 {
-    std::vector<double> distances(signatures.cols());
-    for (int i = 0; i < signatures.cols(); ++i) {
-        distances[i] = Euclid::chi2(signatures.col(vidx), signatures.col(i));
-    }
+    Arr matrix;
+    Euclid::distance_matrix(signatures.col(vidx),
+                            signatures,
+                            matrix,
+                            Euclid::HistogramDistance::chi2);
+    std::vector<double> distances(matrix.data(), matrix.data() + matrix.size());
     std::vector<uint8_t> colors;
     Euclid::colormap(
         igl::COLOR_MAP_TYPE_JET, distances, colors, true, false, true);
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <vector>
+
+#include <CGAL/boost/graph/properties.h>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+namespace Euclid
+{
+/**@{ @ingroup PkgDescriptor*/
+
+/** Heat kernel signature without a full spectral decomposition.
+ *
+ *  The heat kernel signature is the diagonal of the heat operator
+ *  @f$e^{-tL}@f$. Instead of summing over the eigenpairs of the Laplacian as
+ *  HKS does, it is approximated by a Chebyshev polynomial expansion of the
+ *  heat operator [1], applied to random probe vectors whose products estimate
+ *  the diagonal [2]. Only sparse matrix-vector products are needed, one per
+ *  polynomial degree and probe, and the probes run in parallel.
+ *
+ *  The stochastic estimate is poor for large time scales, where the heat
+ *  operator is dominated by a few low-frequency eigenfunctions. Those are
+ *  computed exactly and deflated from the probes, so that only the fast
+ *  decaying remainder is estimated.
+ *
+ *  There are two accuracy controls, the number of probes, the error of the
+ *  estimate decreasing as one over its square root, and the truncation
+ *  tolerance of the Chebyshev expansion, which determines the polynomial
+ *  degree.
+ *
+ *  **Reference**
+ *
+ *  [1] Hammond D. K., Vandergheynst P., Gribonval R..
+ *  Wavelets on graphs via spectral graph theory.
+ *  Applied and Computational Harmonic Analysis, 2011.
+ *
+ *  [2] Bekas C., Kokiopoulou E., Saad Y..
+ *  An estimator for the diagonal of a matrix.
+ *  Applied Numerical Mathematics, 2007.
+ *
+ *  [3] Tang J., Saad Y..
+ *  A probing method for computing the diagonal of a matrix inverse.
+ *  Numerical Linear Algebra with Applications, 2012.
+ *
+ *  @sa HKS
+ */
+template<typename Mesh>
+class ChebyshevHKS
+{
+public:
+    using VPMap =
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type;
+    using Point_3 = typename boost::property_traits<VPMap>::value_type;
+    using Kernel = typename CGAL::Kernel_traits<Point_3>::Kernel;
+    using FT = typename Kernel::FT;
+    using Vertex = typename boost::graph_traits<Mesh>::vertex_descriptor;
+    using Vec = Eigen::Matrix<FT, Eigen::Dynamic, 1>;
+    using Mat = Eigen::Matrix<FT, Eigen::Dynamic, Eigen::Dynamic>;
+    using SpMat = Eigen::SparseMatrix<FT>;
+
+public:
+    /** Build up the necessary computational components.
+     *
+     *  Assemble the symmetric Laplacian and compute the few low-frequency
+     *  eigenpairs to deflate.
+     *
+     *  @param mesh The target mesh.
+     *  @param k Number of low-frequency eigenpairs computed exactly, at least
+     *  2 as the default time range depends on the first nonzero eigenvalue.
+     *  @param probes Number of random probe vectors.
+     *  @param tolerance Truncation tolerance of the Chebyshev coefficients.
+     *  @param max_order The maximum polynomial degree.
+     */
+    void build(const Mesh& mesh,
+               unsigned k = 20,
+               unsigned probes = 100,
+               double tolerance = 1e-6,
+               unsigned max_order = 1000);
+
+    /** Compute hks for all vertices.
+     *
+     *  @param hks Output heat kernel signatures
+     *  @param tscales Number of time scales to use.
+     *  @param tmin The minimum time value, default to -1 which will use the
+     *  parameter setting described in the paper of HKS, with the largest
+     *  eigenvalue replaced by its upper bound.
+     *  @param tmax The maximum time value, default to -1 which will use the
+     *  parameter setting described in the paper of HKS.
+     */
+    template<typename Derived>
+    void compute(Eigen::ArrayBase<Derived>& hks,
+                 unsigned tscales = 100,
+                 float tmin = -1.0f,
+                 float tmax = -1.0f);
+
+    /** Compute hks for a subset of vertices.
+     *
+     *  The probes still run over the whole mesh, as the normalization of each
+     *  time scale sums over all vertices, but only the products of the subset
+     *  are accumulated.
+     *
+     *  @param hks Output heat kernel signatures, one column per vertex in the
+     *  subset.
+     *  @param vertices The subset of vertices.
+     *  @param tscales Number of time scales to use.
+     *  @param tmin The minimum time value.
+     *  @param tmax The maximum time value.
+     *
+     *  @sa compute
+     */
+    template<typename Derived>
+    void compute(Eigen::ArrayBase<Derived>& hks,
+                 const std::vector<Vertex>& vertices,
+                 unsigned tscales = 100,
+                 float tmin = -1.0f,
+                 float tmax = -1.0f);
+
+    /** Compute hks for all vertices, one block of vertices at a time.
+     *
+     *  Only one block of signatures is held in memory, which is passed to the
+     *  callback as callback(first, block), where first is the index of the
+     *  first vertex and block holds one column per vertex. Note that the
+     *  Chebyshev recurrence is repeated for every block.
+     *
+     *  @param callback The callback receiving each block.
+     *  @param block_size Number of vertices in each block.
+     *  @param tscales Number of time scales to use.
+     *  @param tmin The minimum time value.
+     *  @param tmax The maximum time value.
+     *
+     *  @sa compute
+     */
+    template<typename Callback>
+    void compute_blocks(Callback&& callback,
+                        unsigned block_size = 65536,
+                        unsigned tscales = 100,
+                        float tmin = -1.0f,
+                        float tmax = -1.0f);
+
+    /** The polynomial degree used in the last computation.
+     *
+     */
+    unsigned order() const;
+
+private:
+    Vec _times(unsigned tscales, float tmin, float tmax) const;
+
+    Mat _heat(const Vec& times, const std::vector<int>& indices);
+
+private:
+    const Mesh* _mesh;
+    SpMat _laplacian; // @f$D^{-1/2}SD^{-1/2}@f$.
+    Vec _inv_mass;    // @f$D^{-1}@f$.
+    Vec _lambda;      // Deflated eigenvalues.
+    Mat _phi;         // Deflated eigenfunctions.
+    FT _lambda_bound; // Upper bound of the eigenvalues.
+    std::vector<int> _colors; // Colors of the probes.
+    unsigned _ncolors;
+    unsigned _probes;
+    unsigned _max_order;
+    double _tolerance;
+    unsigned _order;
+};
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/ChebyshevHKS.cpp"
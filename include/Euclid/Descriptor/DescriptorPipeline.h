@@ -0,0 +1,181 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <CGAL/boost/graph/properties.h>
+#include <Eigen/Core>
+
+namespace Euclid
+{
+/**@{ @ingroup PkgDescriptor*/
+
+/** Parameters of a HKS request.
+ *
+ *  @sa HKS::compute
+ */
+struct HKSParams
+{
+    /** Number of time scales. */
+    unsigned tscales = 100;
+
+    /** The minimum time value, -1 to use the default. */
+    float tmin = -1.0f;
+
+    /** The maximum time value, -1 to use the default. */
+    float tmax = -1.0f;
+};
+
+/** Parameters of a WKS request.
+ *
+ *  @sa WKS::compute
+ */
+struct WKSParams
+{
+    /** Number of energy scales. */
+    unsigned escales = 100;
+
+    /** The minimum energy value, -1 to use the default. */
+    float emin = -1.0f;
+
+    /** The maximum energy value, -1 to use the default. */
+    float emax = -1.0f;
+
+    /** The energy variance, -1 to use the default. */
+    float sigma = -1.0f;
+};
+
+/** Parameters of a spin image request.
+ *
+ *  @sa SpinImage::compute
+ */
+struct SpinImageParams
+{
+    /** Multiple of the mesh resolution used as bin size. */
+    float bin_scale = 1.0f;
+
+    /** Number of rows and columns of the images. */
+    int image_width = 16;
+
+    /** Maximum support angle in degrees. */
+    float support_angle = 90.0f;
+};
+
+/** Descriptors computed by a DescriptorPipeline.
+ *
+ *  The descriptors of each kind are stored in the order they are requested,
+ *  one column per vertex.
+ *
+ *  @tparam T Scalar type.
+ */
+template<typename T>
+struct DescriptorBundle
+{
+    using Array = Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+    /** Heat kernel signatures. */
+    std::vector<Array> hks;
+
+    /** Wave kernel signatures. */
+    std::vector<Array> wks;
+
+    /** Spin images. */
+    std::vector<Array> spin_images;
+
+    /** Elapsed seconds of each stage, that of a spin image request being
+     *  summed over its blocks.
+     */
+    std::vector<std::pair<std::string, double>> timings;
+};
+
+/** Compute several descriptors of a mesh at once.
+ *
+ *  The descriptors are requested first, then build computes the intermediate
+ *  data they depend on exactly once, i.e. the spectrum and its squared
+ *  eigenfunctions for HKS and WKS, and the vertex normals and the mesh
+ *  resolution for spin images. Finally compute evaluates all the requests
+ *  concurrently, the spin images being further split into blocks of
+ *  vertices, and all of them are scheduled dynamically among the threads.
+ *
+ *  @sa HKS, WKS, SpinImage
+ */
+template<typename Mesh>
+class DescriptorPipeline
+{
+public:
+    using VPMap =
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type;
+    using Point_3 = typename boost::property_traits<VPMap>::value_type;
+    using Kernel = typename CGAL::Kernel_traits<Point_3>::Kernel;
+    using Vector_3 = typename Kernel::Vector_3;
+    using FT = typename Kernel::FT;
+    using Vertex = typename boost::graph_traits<Mesh>::vertex_descriptor;
+    using Vec = Eigen::Matrix<FT, Eigen::Dynamic, 1>;
+    using Mat = Eigen::Matrix<FT, Eigen::Dynamic, Eigen::Dynamic>;
+
+public:
+    /** Request a HKS.
+     *
+     *  @return The index of the request among the HKS.
+     */
+    unsigned add(const HKSParams& params);
+
+    /** Request a WKS.
+     *
+     *  @return The index of the request among the WKS.
+     */
+    unsigned add(const WKSParams& params);
+
+    /** Request spin images.
+     *
+     *  @return The index of the request among the spin images.
+     */
+    unsigned add(const SpinImageParams& params);
+
+    /** Compute the intermediate data of the requested descriptors.
+     *
+     *  @param mesh The target mesh.
+     *  @param k Number of eigenpairs for the spectral descriptors.
+     */
+    void build(const Mesh& mesh, unsigned k = 300);
+
+    /** Compute the requested descriptors.
+     *
+     *  @param bundle The output descriptors, along with the timings of both
+     *  build and compute.
+     */
+    void compute(DescriptorBundle<FT>& bundle) const;
+
+    /** The eigenvalues, empty if no spectral descriptor is requested.
+     *
+     */
+    const Vec& eigenvalues() const;
+
+    /** The vertex normals, empty if no spin image is requested.
+     *
+     */
+    const std::vector<Vector_3>& vertex_normals() const;
+
+    /** The mesh resolution, 0 if no spin image is requested.
+     *
+     */
+    FT resolution() const;
+
+private:
+    const Mesh* _mesh = nullptr;
+    std::vector<HKSParams> _hks;
+    std::vector<WKSParams> _wks;
+    std::vector<SpinImageParams> _spin_images;
+    Vec _lambda;
+    Mat _phi2;
+    std::vector<Vector_3> _vnormals;
+    FT _resolution = 0;
+    std::vector<Vertex> _vertices; // Sorted by index.
+    std::vector<std::pair<std::string, double>> _timings;
+};
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/DescriptorPipeline.cpp"
@@ -0,0 +1,109 @@
+/** Batched distances between sets of descriptors.
+ *
+ *  The distances in Histogram compare a single pair of descriptors, and
+ *  matching a set against another calls them for every pair. This package
+ *  computes them in batches, the full distance matrix, one block of queries
+ *  at a time, or only the k nearest targets of every query so that the full
+ *  matrix is never held in memory.
+ *
+ *  Both sets are split into tiles that fit in cache and the tiles run in
+ *  parallel if OpenMP is enabled. The L2 distances of a tile are computed from
+ *  a matrix product through @f$\|q-t\|^2=\|q\|^2+\|t\|^2-2q^Tt@f$, which is
+ *  much faster but loses accuracy for nearly equal descriptors, the error
+ *  being about @f$\sqrt{\epsilon}\|q\|@f$ rather than @f$\epsilon\|q\|@f$.
+ *  The other distances are computed per pair with the vectorized expressions
+ *  of Histogram and equal them exactly.
+ *
+ *  @defgroup PkgDistanceMatrix DistanceMatrix
+ *  @ingroup PkgDescriptor
+ */
+#pragma once
+
+#include <Eigen/Core>
+
+namespace Euclid
+{
+/** @{*/
+
+/** The distance between two descriptors.
+ *
+ */
+enum class HistogramDistance
+{
+    /** L1 distance, see l1. */
+    l1,
+
+    /** L2 distance, see l2. */
+    l2,
+
+    /** Chi-squared distance, see chi2. */
+    chi2,
+
+    /** Asymmetric chi-squared distance, the queries being the first
+     *  argument, see chi2_asym.
+     */
+    chi2_asym
+};
+
+/** Distances between every pair of query and target descriptors.
+ *
+ *  @param queries The query descriptors, one per column.
+ *  @param targets The target descriptors, one per column.
+ *  @param distances The output distances, the distance between query i and
+ *  target j being at (i, j).
+ *  @param metric The distance to use.
+ */
+template<typename DerivedA, typename DerivedB, typename DerivedC>
+void distance_matrix(const Eigen::ArrayBase<DerivedA>& queries,
+                     const Eigen::ArrayBase<DerivedB>& targets,
+                     Eigen::ArrayBase<DerivedC>& distances,
+                     HistogramDistance metric = HistogramDistance::l2);
+
+/** Distances between every pair of query and target descriptors, one block of
+ *  queries at a time.
+ *
+ *  Only one block of rows of the distance matrix is held in memory, which is
+ *  passed to the callback as callback(first, block), where first is the index
+ *  of the first query and block holds one row per query.
+ *
+ *  @param queries The query descriptors, one per column.
+ *  @param targets The target descriptors, one per column.
+ *  @param callback The callback receiving each block.
+ *  @param block_size Number of queries in each block.
+ *  @param metric The distance to use.
+ *
+ *  @sa distance_matrix
+ */
+template<typename DerivedA, typename DerivedB, typename Callback>
+void distance_matrix_blocks(const Eigen::ArrayBase<DerivedA>& queries,
+                            const Eigen::ArrayBase<DerivedB>& targets,
+                            Callback&& callback,
+                            unsigned block_size = 1024,
+                            HistogramDistance metric = HistogramDistance::l2);
+
+/** The k nearest targets of every query.
+ *
+ *  The distances are computed tile by tile and only the k nearest targets of
+ *  each query are kept, ties being broken by the smaller index.
+ *
+ *  @param queries The query descriptors, one per column.
+ *  @param targets The target descriptors, one per column.
+ *  @param k Number of nearest targets, at most the number of targets.
+ *  @param indices The output indices of the nearest targets, one column per
+ *  query in ascending order of distance.
+ *  @param distances The output distances of the nearest targets, in the same
+ *  layout as indices.
+ *  @param metric The distance to use.
+ */
+template<typename DerivedA, typename DerivedB, typename DerivedC>
+void nearest_neighbors(const Eigen::ArrayBase<DerivedA>& queries,
+                       const Eigen::ArrayBase<DerivedB>& targets,
+                       unsigned k,
+                       Eigen::ArrayXXi& indices,
+                       Eigen::ArrayBase<DerivedC>& distances,
+                       HistogramDistance metric = HistogramDistance::l2);
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/DistanceMatrix.cpp"
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <CGAL/boost/graph/properties.h>
 #include <Eigen/Core>
 
@@ -55,6 +57,21 @@ public:
                const Vec* eigenvalues,
                const Mat* eigenfunctions);
 
+    /** Build up the necessary computational components.
+     *
+     *  From precomputed eigenvalues and squared eigenfunctions. The squared
+     *  eigenfunctions are referenced instead of copied, so that they could be
+     *  shared with other spectral descriptors, and must be kept alive.
+     *
+     *  @param mesh The target mesh.
+     *  @param eigenvalues Precomputed eigenvalues.
+     *  @param squared_eigenfunctions Precomputed eigenfunctions squared
+     *  element-wise.
+     */
+    void build_squared(const Mesh& mesh,
+                       const Vec* eigenvalues,
+                       const Mat* squared_eigenfunctions);
+
     /** Compute hks for all vertices.
      *
      *  @param hks Output heat kernel signatures
@@ -70,9 +87,58 @@ public:
                  float tmin = -1.0f,
                  float tmax = -1.0f);
 
+    /** Compute hks for a subset of vertices.
+     *
+     *  The signatures are normalized in the same way as for all vertices.
+     *
+     *  @param hks Output heat kernel signatures, one column per vertex in the
+     *  subset.
+     *  @param vertices The subset of vertices.
+     *  @param tscales Number of time scales to use.
+     *  @param tmin The minimum time value.
+     *  @param tmax The maximum time value.
+     *
+     *  @sa compute
+     */
+    template<typename Derived>
+    void compute(Eigen::ArrayBase<Derived>& hks,
+                 const std::vector<Vertex>& vertices,
+                 unsigned tscales = 100,
+                 float tmin = -1.0f,
+                 float tmax = -1.0f);
+
+    /** Compute hks for all vertices, one block of vertices at a time.
+     *
+     *  Only one block of signatures is held in memory, which is passed to the
+     *  callback as callback(first, block), where first is the index of the
+     *  first vertex and block holds one column per vertex.
+     *
+     *  @param callback The callback receiving each block.
+     *  @param block_size Number of vertices in each block.
+     *  @param tscales Number of time scales to use.
+     *  @param tmin The minimum time value.
+     *  @param tmax The maximum time value.
+     *
+     *  @sa compute
+     */
+    template<typename Callback>
+    void compute_blocks(Callback&& callback,
+                        unsigned block_size = 65536,
+                        unsigned tscales = 100,
+                        float tmin = -1.0f,
+                        float tmax = -1.0f);
+
+private:
+    Mat _weights(unsigned tscales, float tmin, float tmax) const;
+
+    void _build_eigenvalues(const Mesh& mesh, const Vec& eigenvalues);
+
+    const Mat& _squared() const;
+
 private:
     const Mesh* _mesh;
-    Mat _phi2;     // @f$\phi * \phi@f$.
+    Mat _phi2; // @f$\phi * \phi@f$.
+    const Mat* _shared_phi2 = nullptr; // Used instead of _phi2 if set.
     Vec _emlambda; // @f$e^{-\lambda}@f$.
     FT _lambda_max;
     FT _lambda_min;
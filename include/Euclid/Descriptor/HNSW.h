@@ -0,0 +1,147 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Euclid/Descriptor/DistanceMatrix.h>
+
+namespace Euclid
+{
+/**@{ @ingroup PkgDescriptor*/
+
+/** Approximate nearest neighbor index of descriptors.
+ *
+ *  The descriptors are organized in a hierarchical navigable small world
+ *  graph [1]. Every descriptor is linked to a few of its nearest neighbors
+ *  on layer 0, and to fewer and fewer of them on the exponentially sparser
+ *  upper layers. A query descends greedily from the top layer and explores
+ *  the neighborhood of the closest descriptors on layer 0, visiting a small
+ *  fraction of the index.
+ *
+ *  The search width of a query trades accuracy for speed, a width of a few
+ *  times k usually recovers most of the exact k nearest neighbors, see
+ *  nearest_neighbors for the exact search. The graph does not rely on the
+ *  triangle inequality, so both l2 and chi2 are supported.
+ *
+ *  The index is serializable, e.g. by Euclid::serialize and
+ *  Euclid::deserialize in Util/Serialize.h.
+ *
+ *  **Reference**
+ *
+ *  [1] Malkov Y. A., Yashunin D. A..
+ *  Efficient and robust approximate nearest neighbor search using
+ *  hierarchical navigable small world graphs.
+ *  IEEE Transactions on Pattern Analysis and Machine Intelligence, 2018.
+ *
+ *  @tparam T Scalar type of the descriptors.
+ *
+ *  @sa nearest_neighbors
+ */
+template<typename T>
+class HNSW
+{
+public:
+    /** Build the index from scratch.
+     *
+     *  @param descriptors The descriptors, one per column.
+     *  @param metric The distance to use, one of l1, l2 and chi2.
+     *  @param m Number of links per descriptor on the upper layers, twice as
+     *  many on layer 0.
+     *  @param ef_construction Search width when inserting a descriptor.
+     */
+    template<typename Derived>
+    void build(const Eigen::ArrayBase<Derived>& descriptors,
+               HistogramDistance metric = HistogramDistance::l2,
+               unsigned m = 16,
+               unsigned ef_construction = 200);
+
+    /** Insert more descriptors into the index.
+     *
+     *  The new descriptors are indexed after the existing ones.
+     *
+     *  @param descriptors The descriptors, one per column.
+     */
+    template<typename Derived>
+    void add(const Eigen::ArrayBase<Derived>& descriptors);
+
+    /** Search the approximate k nearest descriptors of every query.
+     *
+     *  The queries run in parallel if OpenMP is enabled.
+     *
+     *  @param queries The query descriptors, one per column.
+     *  @param k Number of nearest descriptors, at most the size of the index.
+     *  @param indices The output indices of the nearest descriptors, one
+     *  column per query in ascending order of distance, -1 if fewer
+     *  descriptors are reachable in the graph.
+     *  @param distances The output distances of the nearest descriptors, in
+     *  the same layout as indices.
+     *  @param ef Search width, at least k, default to 0 which uses
+     *  max(k, 50).
+     */
+    template<typename DerivedA, typename DerivedB>
+    void query(const Eigen::ArrayBase<DerivedA>& queries,
+               unsigned k,
+               Eigen::ArrayXXi& indices,
+               Eigen::ArrayBase<DerivedB>& distances,
+               unsigned ef = 0) const;
+
+    /** Number of indexed descriptors.
+     *
+     */
+    int size() const;
+
+    /** Dimension of the descriptors.
+     *
+     */
+    int dim() const;
+
+    /** Save the index into an archive.
+     *
+     */
+    template<typename Archive>
+    void save(Archive& ar) const;
+
+    /** Load the index from an archive.
+     *
+     */
+    template<typename Archive>
+    void load(Archive& ar);
+
+private:
+    // A descriptor and its distance to the target of a search
+    using Candidate = std::pair<T, int>;
+
+    const T* _descriptor(int i) const;
+
+    T _distance(const T* a, const T* b) const;
+
+    int _random_level(int i) const;
+
+    void _insert(int i, std::vector<unsigned>& visited, unsigned& tag);
+
+    std::vector<Candidate> _search_layer(const T* target,
+                                         const std::vector<Candidate>& entries,
+                                         unsigned ef,
+                                         int level,
+                                         std::vector<unsigned>& visited,
+                                         unsigned& tag) const;
+
+    std::vector<int> _select(std::vector<Candidate> candidates,
+                             unsigned count) const;
+
+private:
+    HistogramDistance _metric = HistogramDistance::l2;
+    unsigned _m = 16;
+    unsigned _ef_construction = 200;
+    int _dim = 0;
+    std::vector<T> _data; // Descriptors stored contiguously.
+    std::vector<std::vector<std::vector<int>>> _links; // Per node and layer.
+    int _entry = -1;
+    int _max_level = -1;
+};
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/HNSW.cpp"
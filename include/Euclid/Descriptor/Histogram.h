@@ -1,7 +1,9 @@
 /**Measure histograms.
  *
  * Histograms are commonly used as shape descriptors. This package contains
- * functions to compute distances between histograms.
+ * functions to compute distances between histograms, in full precision,
+ * directly on descriptors quantized with QuantizedDescriptors, or on sparse
+ * descriptors such as the sparse spin images.
  * @defgroup PkgHistogram Histogram
  * @ingroup PkgDescriptor
  */
@@ -10,6 +12,8 @@
 #include <type_traits>
 
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Euclid/Descriptor/Quantization.h>
 
 namespace Euclid
 {
@@ -61,6 +65,76 @@ template<typename DerivedA,
 T chi2_asym(const Eigen::ArrayBase<DerivedA>& d1,
             const Eigen::ArrayBase<DerivedB>& d2);
 
+/** L1 distance of quantized descriptors.
+ *
+ */
+template<typename T>
+float l1(const QuantizedRef<T>& d1, const QuantizedRef<T>& d2);
+
+/** L2 distance of quantized descriptors.
+ *
+ */
+template<typename T>
+float l2(const QuantizedRef<T>& d1, const QuantizedRef<T>& d2);
+
+/** Chi-squared distance of quantized descriptors.
+ *
+ */
+template<typename T>
+float chi2(const QuantizedRef<T>& d1, const QuantizedRef<T>& d2);
+
+/** Asymmetric chi-squared distance of quantized descriptors.
+ *
+ */
+template<typename T>
+float chi2_asym(const QuantizedRef<T>& d1, const QuantizedRef<T>& d2);
+
+/** L1 distance of sparse descriptors.
+ *
+ *  The descriptors are sparse vectors, e.g. columns of a column-major sparse
+ *  matrix, and only their nonzero elements are visited.
+ */
+template<typename DerivedA,
+         typename DerivedB,
+         typename T = typename DerivedA::Scalar,
+         typename = std::enable_if_t<std::is_same_v<typename DerivedA::Scalar,
+                                                    typename DerivedB::Scalar>>>
+T l1(const Eigen::SparseCompressedBase<DerivedA>& d1,
+     const Eigen::SparseCompressedBase<DerivedB>& d2);
+
+/** L2 distance of sparse descriptors.
+ *
+ */
+template<typename DerivedA,
+         typename DerivedB,
+         typename T = typename DerivedA::Scalar,
+         typename = std::enable_if_t<std::is_same_v<typename DerivedA::Scalar,
+                                                    typename DerivedB::Scalar>>>
+T l2(const Eigen::SparseCompressedBase<DerivedA>& d1,
+     const Eigen::SparseCompressedBase<DerivedB>& d2);
+
+/** Chi-squared distance of sparse descriptors.
+ *
+ */
+template<typename DerivedA,
+         typename DerivedB,
+         typename T = typename DerivedA::Scalar,
+         typename = std::enable_if_t<std::is_same_v<typename DerivedA::Scalar,
+                                                    typename DerivedB::Scalar>>>
+T chi2(const Eigen::SparseCompressedBase<DerivedA>& d1,
+       const Eigen::SparseCompressedBase<DerivedB>& d2);
+
+/** Asymmetric chi-squared distance of sparse descriptors.
+ *
+ */
+template<typename DerivedA,
+         typename DerivedB,
+         typename T = typename DerivedA::Scalar,
+         typename = std::enable_if_t<std::is_same_v<typename DerivedA::Scalar,
+                                                    typename DerivedB::Scalar>>>
+T chi2_asym(const Eigen::SparseCompressedBase<DerivedA>& d1,
+            const Eigen::SparseCompressedBase<DerivedB>& d2);
+
 /** @}*/
 } // namespace Euclid
 
@@ -0,0 +1,163 @@
+/** Reduced precision storage of descriptors.
+ *
+ *  Descriptors are computed in the scalar type of the mesh kernel, usually
+ *  double, which is wasteful for large descriptor databases. This package
+ *  stores them column-wise in float, half or int8 precision. The half and int8
+ *  storages keep a scale per descriptor, the largest magnitude of the
+ *  descriptor mapping to 1 and 127 respectively, as normalized descriptors
+ *  such as HKS are often small enough to be subnormal in half precision.
+ *
+ *  The relative error of an element is about @f$2^{-24}@f$ for float and
+ *  @f$2^{-11}@f$ for half, down to elements about @f$10^{-4}@f$ of the
+ *  largest magnitude of the descriptor. The absolute error of an int8 element
+ *  is at most 1/254 of the largest magnitude, so small bins lose most of their
+ *  precision, which matters for distances weighting them up, e.g. chi2. The
+ *  distances in Histogram operate on the quantized form directly.
+ *
+ *  @defgroup PkgQuantization Quantization
+ *  @ingroup PkgDescriptor
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <Eigen/Core>
+
+namespace Euclid
+{
+/** @{*/
+
+/** A read-only view of a single quantized descriptor.
+ *
+ *  @tparam T The storage type.
+ */
+template<typename T>
+struct QuantizedRef
+{
+    /** Pointer to the first element. */
+    const T* data;
+
+    /** Number of elements. */
+    Eigen::Index size;
+
+    /** Scale of the elements, 1 if the storage is float. */
+    float scale;
+
+    /** The dequantized descriptor as a float array expression.
+     *
+     *  The expression is evaluated lazily, no temporary is created when it is
+     *  used in another expression.
+     */
+    auto array() const
+    {
+        return Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>>(data, size)
+                   .template cast<float>() *
+               scale;
+    }
+};
+
+/** Descriptors stored column-wise in reduced precision.
+ *
+ *  @tparam T The storage type, float, Eigen::half or int8_t.
+ */
+template<typename T>
+class QuantizedDescriptors
+{
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, Eigen::half> ||
+                      std::is_same_v<T, int8_t>,
+                  "Storage type must be float, Eigen::half or int8_t.");
+
+    static constexpr bool scaled = !std::is_same_v<T, float>;
+
+public:
+    using Storage = T;
+    using Data = Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic>;
+    using Scales = Eigen::Array<float, Eigen::Dynamic, 1>;
+
+public:
+    /** Create an empty storage.
+     *
+     */
+    QuantizedDescriptors() = default;
+
+    /** Create a storage for a number of descriptors.
+     *
+     *  @param dim The dimension of each descriptor.
+     *  @param count The number of descriptors.
+     */
+    QuantizedDescriptors(Eigen::Index dim, Eigen::Index count);
+
+    /** Quantize descriptors.
+     *
+     *  @param descriptors The descriptors, one per column.
+     */
+    template<typename Derived>
+    explicit QuantizedDescriptors(const Eigen::ArrayBase<Derived>& descriptors);
+
+    /** Resize the storage, the content is undefined afterwards.
+     *
+     *  @param dim The dimension of each descriptor.
+     *  @param count The number of descriptors.
+     */
+    void resize(Eigen::Index dim, Eigen::Index count);
+
+    /** Quantize a block of consecutive descriptors.
+     *
+     *  The storage must be large enough. Together with the block-streaming
+     *  compute of the descriptors, it avoids holding all descriptors in full
+     *  precision.
+     *
+     *  @param first Index of the first descriptor in the block.
+     *  @param block The descriptors, one per column.
+     */
+    template<typename Derived>
+    void set(Eigen::Index first, const Eigen::ArrayBase<Derived>& block);
+
+    /** Dequantize all descriptors.
+     *
+     *  @param descriptors The output descriptors, one per column.
+     */
+    template<typename Derived>
+    void dequantize(Eigen::ArrayBase<Derived>& descriptors) const;
+
+    /** A single descriptor.
+     *
+     */
+    QuantizedRef<T> col(Eigen::Index i) const;
+
+    /** The dimension of each descriptor.
+     *
+     */
+    Eigen::Index rows() const;
+
+    /** The number of descriptors.
+     *
+     */
+    Eigen::Index cols() const;
+
+    /** The quantized elements.
+     *
+     */
+    const Data& data() const;
+
+    /** The scale of each descriptor, empty if the storage is float.
+     *
+     */
+    const Scales& scales() const;
+
+    /** Number of bytes used by the elements and the scales.
+     *
+     */
+    std::size_t bytes() const;
+
+private:
+    Data _data;
+    Scales _scales;
+};
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/Quantization.cpp"
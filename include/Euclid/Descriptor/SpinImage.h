@@ -3,10 +3,18 @@
 #include <vector>
 #include <CGAL/boost/graph/properties.h>
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 #include <Euclid/Util/Memory.h>
 
 namespace Euclid
 {
+
+namespace _impl
+{
+template<typename Point_3>
+class PointGrid;
+} // namespace _impl
+
 /**@{ @ingroup PkgDescriptor*/
 
 /** The spin image descriptor.
@@ -15,6 +23,16 @@ namespace Euclid
  *  on a mesh, an image is generated by projecting points onto the image
  *  plane within a local support.
  *
+ *  The vertices are bucketed into a uniform grid when building, so that only
+ *  those near the support are visited for each image, and the images are the
+ *  same as visiting all vertices. The images are computed in parallel if
+ *  OpenMP is enabled.
+ *
+ *  Most bins are zero due to the narrow support and the support angle, so
+ *  the images can also be output as a sparse matrix, which is usually several
+ *  times smaller than the dense images. Histogram provides the distances on
+ *  its columns, and it converts to dense on demand, e.g. by toDense().
+ *
  *  **Reference**
  *
  *  Johnson A E, Hebert M.
@@ -65,6 +83,83 @@ public:
                  int image_width = 16,
                  float support_angle = 90.0f);
 
+    /** Compute the spin image descriptor for a subset of vertices.
+     *
+     *  @param spin_img The output spin images, one column per vertex in the
+     *  subset.
+     *  @param vertices The subset of vertices.
+     *  @param bin_scale Multiple of the mesh resolution.
+     *  @param image_width Number of rows and columns for the image.
+     *  @param support_angle Maximum support angle in degrees.
+     *
+     *  @sa compute
+     */
+    template<typename Derived>
+    void compute(Eigen::ArrayBase<Derived>& spin_img,
+                 const std::vector<Vertex>& vertices,
+                 float bin_scale = 1.0f,
+                 int image_width = 16,
+                 float support_angle = 90.0f);
+
+    /** Compute the sparse spin image descriptor for all vertices.
+     *
+     *  The images are computed densely one block of vertices at a time, only
+     *  the nonzero bins being stored, so the dense images of all vertices are
+     *  never held in memory.
+     *
+     *  @param spin_img The output spin images, one column per vertex.
+     *  @param bin_scale Multiple of the mesh resolution.
+     *  @param image_width Number of rows and columns for the image.
+     *  @param support_angle Maximum support angle in degrees.
+     *
+     *  @sa compute
+     */
+    template<typename T>
+    void compute(Eigen::SparseMatrix<T>& spin_img,
+                 float bin_scale = 1.0f,
+                 int image_width = 16,
+                 float support_angle = 90.0f);
+
+    /** Compute the sparse spin image descriptor for a subset of vertices.
+     *
+     *  @param spin_img The output spin images, one column per vertex in the
+     *  subset.
+     *  @param vertices The subset of vertices.
+     *  @param bin_scale Multiple of the mesh resolution.
+     *  @param image_width Number of rows and columns for the image.
+     *  @param support_angle Maximum support angle in degrees.
+     *
+     *  @sa compute
+     */
+    template<typename T>
+    void compute(Eigen::SparseMatrix<T>& spin_img,
+                 const std::vector<Vertex>& vertices,
+                 float bin_scale = 1.0f,
+                 int image_width = 16,
+                 float support_angle = 90.0f);
+
+    /** Compute the spin image descriptor for all vertices, one block of
+     *  vertices at a time.
+     *
+     *  Only one block of spin images is held in memory, which is passed to the
+     *  callback as callback(first, block), where first is the index of the
+     *  first vertex and block holds one column per vertex.
+     *
+     *  @param callback The callback receiving each block.
+     *  @param block_size Number of vertices in each block.
+     *  @param bin_scale Multiple of the mesh resolution.
+     *  @param image_width Number of rows and columns for the image.
+     *  @param support_angle Maximum support angle in degrees.
+     *
+     *  @sa compute
+     */
+    template<typename Callback>
+    void compute_blocks(Callback&& callback,
+                        unsigned block_size = 65536,
+                        float bin_scale = 1.0f,
+                        int image_width = 16,
+                        float support_angle = 90.0f);
+
 public:
     /** The mesh being processed.
      *
@@ -80,6 +175,14 @@ public:
      *
      */
     FT resolution = 0.0;
+
+private:
+    std::vector<Vertex> _vertices() const;
+
+private:
+    _impl::PointGrid<Point_3> _grid;
+    // Positions and normals in the grid order, one column per coordinate.
+    Eigen::Array<FT, Eigen::Dynamic, 6> _attributes;
 };
 
 /** @}*/
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <CGAL/boost/graph/properties.h>
 #include <Eigen/Core>
 
@@ -54,6 +56,21 @@ public:
                const Vec* eigenvalues,
                const Mat* eigenfunctions);
 
+    /** Build up the necessary computational components.
+     *
+     *  From precomputed eigenvalues and squared eigenfunctions. The squared
+     *  eigenfunctions are referenced instead of copied, so that they could be
+     *  shared with other spectral descriptors, and must be kept alive.
+     *
+     *  @param mesh The target mesh.
+     *  @param eigenvalues Precomputed eigenvalues.
+     *  @param squared_eigenfunctions Precomputed eigenfunctions squared
+     *  element-wise.
+     */
+    void build_squared(const Mesh& mesh,
+                       const Vec* eigenvalues,
+                       const Mat* squared_eigenfunctions);
+
     /** Compute wks for all vertices.
      *
      *  @param wks Output wave kernel signatures
@@ -72,9 +89,60 @@ public:
                  float emax = -1.0f,
                  float sigma = -1.0f);
 
+    /** Compute wks for a subset of vertices.
+     *
+     *  @param wks Output wave kernel signatures, one column per vertex in the
+     *  subset.
+     *  @param vertices The subset of vertices.
+     *  @param escales Number of energy scales to use.
+     *  @param emin The minimum energy scale.
+     *  @param emax The maximum energy scale.
+     *  @param sigma The variance of the log normal distribution.
+     *
+     *  @sa compute
+     */
+    template<typename Derived>
+    void compute(Eigen::ArrayBase<Derived>& wks,
+                 const std::vector<Vertex>& vertices,
+                 unsigned escales = 100,
+                 float emin = 0.0f,
+                 float emax = -1.0f,
+                 float sigma = -1.0f);
+
+    /** Compute wks for all vertices, one block of vertices at a time.
+     *
+     *  Only one block of signatures is held in memory, which is passed to the
+     *  callback as callback(first, block), where first is the index of the
+     *  first vertex and block holds one column per vertex.
+     *
+     *  @param callback The callback receiving each block.
+     *  @param block_size Number of vertices in each block.
+     *  @param escales Number of energy scales to use.
+     *  @param emin The minimum energy scale.
+     *  @param emax The maximum energy scale.
+     *  @param sigma The variance of the log normal distribution.
+     *
+     *  @sa compute
+     */
+    template<typename Callback>
+    void compute_blocks(Callback&& callback,
+                        unsigned block_size = 65536,
+                        unsigned escales = 100,
+                        float emin = 0.0f,
+                        float emax = -1.0f,
+                        float sigma = -1.0f);
+
+private:
+    Mat _filters(unsigned escales, float emin, float emax, float sigma) const;
+
+    void _build_eigenvalues(const Mesh& mesh, const Vec& eigenvalues);
+
+    const Mat& _squared() const;
+
 private:
     const Mesh* _mesh;
     Mat _phi2;
+    const Mat* _shared_phi2 = nullptr; // Used instead of _phi2 if set.
     Vec _loglambda;
     FT _lambda_max;
     FT _lambda_min;
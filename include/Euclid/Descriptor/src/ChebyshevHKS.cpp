@@ -0,0 +1,353 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <Euclid/Geometry/OperatorRegistry.h>
+#include <Euclid/Geometry/Spectral.h>
+#include <Euclid/Util/Assert.h>
+
+namespace Euclid
+{
+
+namespace _impl
+{
+
+// Chebyshev coefficients of exp(-tx) on [0, bound] up to the given degree,
+// one column per time value, computed by Chebyshev-Gauss quadrature
+template<typename Vec>
+Eigen::Matrix<typename Vec::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+chebyshev_heat_coefficients(const Vec& times,
+                            typename Vec::Scalar bound,
+                            int order)
+{
+    using T = typename Vec::Scalar;
+    using Mat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+    const int nodes = 2 * (order + 1);
+    const T pi = static_cast<T>(std::acos(-1.0));
+    Mat cosines(order + 1, nodes);
+    Mat values(nodes, times.size());
+    for (int q = 0; q < nodes; ++q) {
+        const T theta = pi * (q + T(0.5)) / nodes;
+        for (int j = 0; j <= order; ++j) {
+            cosines(j, q) = std::cos(j * theta);
+        }
+        const T x = bound * (std::cos(theta) + 1) / 2;
+        for (Eigen::Index i = 0; i < times.size(); ++i) {
+            values(q, i) = std::exp(-times(i) * x);
+        }
+    }
+    Mat coefs = cosines * values * (T(2) / nodes);
+    coefs.row(0) /= 2;
+    return coefs;
+}
+
+// Greedy coloring of the vertices of the graph of a sparse matrix, so that
+// vertices of the same color are more than the distance apart, return the
+// number of colors
+template<typename SpMat>
+int distance_coloring(const SpMat& graph,
+                      int distance,
+                      std::vector<int>& colors)
+{
+    const auto n = static_cast<int>(graph.cols());
+    colors.assign(n, -1);
+    std::vector<int> visited(n, -1);
+    std::vector<int> taken;
+    std::vector<int> frontier, next;
+    for (int v = 0; v < n; ++v) {
+        frontier.assign(1, v);
+        visited[v] = v;
+        for (int r = 0; r < distance; ++r) {
+            next.clear();
+            for (auto u : frontier) {
+                for (typename SpMat::InnerIterator it(graph, u); it; ++it) {
+                    const auto w = static_cast<int>(it.row());
+                    if (visited[w] != v) {
+                        visited[w] = v;
+                        next.push_back(w);
+                        if (colors[w] != -1) {
+                            taken[colors[w]] = v;
+                        }
+                    }
+                }
+            }
+            frontier.swap(next);
+        }
+        int color = 0;
+        while (color < static_cast<int>(taken.size()) && taken[color] == v) {
+            ++color;
+        }
+        if (color == static_cast<int>(taken.size())) {
+            taken.push_back(-1);
+        }
+        colors[v] = color;
+    }
+    return static_cast<int>(taken.size());
+}
+
+} // namespace _impl
+
+template<typename Mesh>
+void ChebyshevHKS<Mesh>::build(const Mesh& mesh,
+                               unsigned k,
+                               unsigned probes,
+                               double tolerance,
+                               unsigned max_order)
+{
+    if (k < 2) {
+        throw std::invalid_argument("At least 2 eigenpairs are required.");
+    }
+    if (probes == 0) {
+        throw std::invalid_argument("At least 1 probe vector is required.");
+    }
+    _mesh = &mesh;
+    _probes = probes;
+    _tolerance = tolerance;
+    _max_order = max_order;
+    _order = 0;
+
+    OperatorRegistry<Mesh> ops;
+    ops.build(mesh);
+    Vec d = ops.diagonal(ops.mass());
+    Vec b = d.unaryExpr([](FT v) { return v == 0 ? 0 : 1 / std::sqrt(v); });
+    _laplacian = ops.matrix(ops.scale(ops.cotangent_laplacian(), b));
+    _inv_mass = b.cwiseAbs2();
+
+    // Gershgorin bound of the largest eigenvalue
+    Vec rows = Vec::Zero(_laplacian.rows());
+    for (int j = 0; j < _laplacian.outerSize(); ++j) {
+        for (typename SpMat::InnerIterator it(_laplacian, j); it; ++it) {
+            rows(it.row()) += std::abs(it.value());
+        }
+    }
+    _lambda_bound = rows.maxCoeff();
+
+    // Probing with colored vectors [3], the estimate is only polluted by the
+    // kernel between vertices of the same color, so the colors are spread as
+    // far apart as the number of probes allows. The count is bounded by the
+    // size of the largest connected component, so the distance stops growing
+    // once the count doesn't increase any more.
+    const auto nv = static_cast<int>(_laplacian.rows());
+    std::vector<int> colors;
+    _colors.clear();
+    for (int distance = 1;; ++distance) {
+        auto n = _impl::distance_coloring(_laplacian, distance, colors);
+        if (n > static_cast<int>(probes) && !_colors.empty()) {
+            break;
+        }
+        auto saturated = !_colors.empty() && n <= _ncolors;
+        _colors.swap(colors);
+        _ncolors = n;
+        if (n > static_cast<int>(probes) || n >= nv || saturated) {
+            break;
+        }
+    }
+
+    spectrum(mesh,
+             k,
+             _lambda,
+             _phi,
+             SpecOp::laplace_beltrami,
+             SpecDecomp::lobpcg);
+    if (_lambda.size() < 2) {
+        throw std::runtime_error(
+            "Unable to compute the low-frequency eigenpairs.");
+    }
+}
+
+template<typename Mesh>
+template<typename Derived>
+void ChebyshevHKS<Mesh>::compute(Eigen::ArrayBase<Derived>& hks,
+                                 unsigned tscales,
+                                 float tmin,
+                                 float tmax)
+{
+    std::vector<int> indices(_laplacian.rows());
+    std::iota(indices.begin(), indices.end(), 0);
+    auto heat = _heat(_times(tscales, tmin, tmax), indices);
+    hks.derived().resize(tscales, indices.size());
+    hks = heat.array();
+}
+
+template<typename Mesh>
+template<typename Derived>
+void ChebyshevHKS<Mesh>::compute(Eigen::ArrayBase<Derived>& hks,
+                                 const std::vector<Vertex>& vertices,
+                                 unsigned tscales,
+                                 float tmin,
+                                 float tmax)
+{
+    auto vimap = get(boost::vertex_index, *_mesh);
+    std::vector<int> indices(vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        indices[i] = static_cast<int>(get(vimap, vertices[i]));
+    }
+    auto heat = _heat(_times(tscales, tmin, tmax), indices);
+    hks.derived().resize(tscales, indices.size());
+    hks = heat.array();
+}
+
+template<typename Mesh>
+template<typename Callback>
+void ChebyshevHKS<Mesh>::compute_blocks(Callback&& callback,
+                                        unsigned block_size,
+                                        unsigned tscales,
+                                        float tmin,
+                                        float tmax)
+{
+    if (block_size == 0) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+    auto times = _times(tscales, tmin, tmax);
+    const auto nv = static_cast<int>(_laplacian.rows());
+    std::vector<int> indices;
+    Eigen::Array<FT, Eigen::Dynamic, Eigen::Dynamic> block;
+    for (int first = 0; first < nv; first += block_size) {
+        const auto n = std::min<int>(block_size, nv - first);
+        indices.resize(n);
+        std::iota(indices.begin(), indices.end(), first);
+        block = _heat(times, indices).array();
+        callback(static_cast<Eigen::Index>(first), block);
+    }
+}
+
+template<typename Mesh>
+typename ChebyshevHKS<Mesh>::Vec ChebyshevHKS<Mesh>::_times(unsigned tscales,
+                                                            float tmin,
+                                                            float tmax) const
+{
+    if (tmin > 0 && tmax > 0) {
+        if (tmin >= tmax) {
+            throw std::invalid_argument("tmin is larger than tmax.");
+        }
+    }
+    else {
+        auto c = static_cast<FT>(4.0 * std::log(10.0));
+        tmin = c / _lambda_bound;
+        tmax = c / std::abs(_lambda(1)); // abs fix numerical error
+    }
+    auto log_tmin = std::log(tmin);
+    auto log_tmax = std::log(tmax);
+    auto log_tstep = (log_tmax - log_tmin) / tscales;
+    Vec times(tscales);
+    for (unsigned i = 0; i < tscales; ++i) {
+        times(i) = std::exp(log_tmin + log_tstep * i);
+    }
+    return times;
+}
+
+template<typename Mesh>
+typename ChebyshevHKS<Mesh>::Mat ChebyshevHKS<Mesh>::_heat(
+    const Vec& times,
+    const std::vector<int>& indices)
+{
+    const auto nv = static_cast<int>(_laplacian.rows());
+    const auto ns = static_cast<int>(indices.size());
+    const auto tscales = static_cast<int>(times.size());
+
+    // Truncate the expansion where all the later coefficients are negligible
+    Mat coefs = _impl::chebyshev_heat_coefficients(
+        times, _lambda_bound, static_cast<int>(_max_order));
+    Vec magnitudes = coefs.cwiseAbs().rowwise().maxCoeff();
+    _order = _max_order;
+    while (_order > 1 && magnitudes(_order) < _tolerance) {
+        --_order;
+    }
+    if (_order == _max_order && magnitudes(_order) >= _tolerance) {
+        EWARNING("The Chebyshev expansion is truncated above the tolerance, "
+                 "try a larger maximum order or a smaller time range.");
+    }
+
+    // The deflated eigenpairs contribute exactly as in HKS
+    Mat decay = (-_lambda * times.transpose()).array().exp().matrix();
+    Vec sums = (_phi.cwiseAbs2().colwise().sum() * decay).transpose();
+    Mat phi2(ns, _phi.cols());
+    Vec inv_mass(ns);
+    for (int i = 0; i < ns; ++i) {
+        phi2.row(i) = _phi.row(indices[i]).cwiseAbs2();
+        inv_mass(i) = _inv_mass(indices[i]);
+    }
+    Mat heat(ns, tscales);
+    heat.noalias() = phi2 * decay;
+
+    // The deflated eigenfunctions are D-orthonormal, so the projection of the
+    // probes onto the rest of the symmetric spectrum is I - UU^T, U = D^1/2 phi
+    Mat basis = _inv_mass.cwiseSqrt().cwiseInverse().asDiagonal() * _phi;
+
+    // Chebyshev recurrence T_{j+1} = 2AT_j - T_{j-1} of the Laplacian scaled
+    // to [-1, 1], on blocks of probes, with the products of the probes and the
+    // polynomials gathered in chunks of degrees and summed through GEMM. Each
+    // round of probes has one vector per color with random signs. Only the
+    // products of the requested vertices are kept, along with their weighted
+    // sums over all vertices for the normalization.
+    constexpr int block = 16;
+    constexpr int chunk = 32;
+    const FT scale = 2 / _lambda_bound;
+    const auto rounds = std::max(_probes / _ncolors, 1u);
+    const auto total = rounds * _ncolors;
+    std::mt19937 gen(0);
+    std::bernoulli_distribution coin;
+    Mat estimate = Mat::Zero(ns, tscales);
+    Vec total_estimate = Vec::Zero(tscales);
+    Mat products(ns, chunk);
+    Vec total_products(chunk);
+    for (unsigned first = 0; first < total; first += block) {
+        const auto nb =
+            static_cast<int>(std::min<unsigned>(block, total - first));
+        Mat probes = Mat::Zero(nv, nb);
+        for (int i = 0; i < nv; ++i) {
+            for (int c = 0; c < nb; ++c) {
+                if (_colors[i] == static_cast<int>((first + c) % _ncolors)) {
+                    probes(i, c) = coin(gen) ? 1 : -1;
+                }
+            }
+        }
+        Mat prev(nv, nb), next(nv, nb);
+        Mat cur = probes - basis * (basis.transpose() * probes);
+        for (int j = 0; j <= static_cast<int>(_order); ++j) {
+            if (j > 0) {
+#pragma omp parallel for schedule(static)
+                for (int c = 0; c < nb; ++c) {
+                    next.col(c).noalias() = _laplacian * cur.col(c);
+                    next.col(c) = scale * next.col(c) - cur.col(c);
+                    if (j > 1) {
+                        next.col(c) = 2 * next.col(c) - prev.col(c);
+                    }
+                }
+                prev.swap(cur);
+                cur.swap(next);
+            }
+            Vec product = (probes.array() * cur.array()).rowwise().sum();
+            for (int i = 0; i < ns; ++i) {
+                products(i, j % chunk) = product(indices[i]);
+            }
+            total_products(j % chunk) = _inv_mass.dot(product);
+            if (j % chunk == chunk - 1 || j == static_cast<int>(_order)) {
+                const auto n = j % chunk + 1;
+                estimate.noalias() +=
+                    products.leftCols(n) * coefs.middleRows(j + 1 - n, n);
+                total_estimate.noalias() +=
+                    coefs.middleRows(j + 1 - n, n).transpose() *
+                    total_products.head(n);
+            }
+        }
+    }
+    heat += inv_mass.asDiagonal() * estimate / static_cast<FT>(rounds);
+    sums += total_estimate / static_cast<FT>(rounds);
+
+    Mat result = heat.transpose();
+    result = sums.cwiseInverse().asDiagonal() * result;
+    return result;
+}
+
+template<typename Mesh>
+unsigned ChebyshevHKS<Mesh>::order() const
+{
+    return _order;
+}
+
+} // namespace Euclid
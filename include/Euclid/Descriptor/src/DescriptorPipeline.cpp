@@ -0,0 +1,208 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <Euclid/Descriptor/HKS.h>
+#include <Euclid/Descriptor/SpinImage.h>
+#include <Euclid/Descriptor/WKS.h>
+#include <Euclid/Geometry/Spectral.h>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+#include <Euclid/Util/Timer.h>
+
+namespace Euclid
+{
+
+template<typename Mesh>
+unsigned DescriptorPipeline<Mesh>::add(const HKSParams& params)
+{
+    _hks.push_back(params);
+    return static_cast<unsigned>(_hks.size() - 1);
+}
+
+template<typename Mesh>
+unsigned DescriptorPipeline<Mesh>::add(const WKSParams& params)
+{
+    _wks.push_back(params);
+    return static_cast<unsigned>(_wks.size() - 1);
+}
+
+template<typename Mesh>
+unsigned DescriptorPipeline<Mesh>::add(const SpinImageParams& params)
+{
+    _spin_images.push_back(params);
+    return static_cast<unsigned>(_spin_images.size() - 1);
+}
+
+template<typename Mesh>
+void DescriptorPipeline<Mesh>::build(const Mesh& mesh, unsigned k)
+{
+    _mesh = &mesh;
+    _timings.clear();
+    _lambda.resize(0);
+    _phi2.resize(0, 0);
+    _vnormals.clear();
+    _resolution = 0;
+    Timer timer;
+
+    if (!_hks.empty() || !_wks.empty()) {
+        timer.tick();
+        Mat phi;
+        spectrum(mesh, k, _lambda, phi);
+        _timings.emplace_back("spectrum", timer.tock());
+
+        timer.tick();
+        _phi2 = phi.array().square().matrix();
+        _timings.emplace_back("squared eigenfunctions", timer.tock());
+    }
+
+    if (!_spin_images.empty()) {
+        timer.tick();
+        auto fnormals = face_normals(mesh);
+        _vnormals = Euclid::vertex_normals(mesh, fnormals);
+        _timings.emplace_back("vertex normals", timer.tock());
+
+        timer.tick();
+        for (auto e : edges(mesh)) {
+            _resolution += edge_length(e, mesh);
+        }
+        _resolution /= static_cast<FT>(num_edges(mesh));
+        _timings.emplace_back("resolution", timer.tock());
+
+        auto vimap = get(boost::vertex_index, mesh);
+        _vertices.resize(num_vertices(mesh));
+        for (auto v : vertices(mesh)) {
+            _vertices[get(vimap, v)] = v;
+        }
+    }
+}
+
+template<typename Mesh>
+void DescriptorPipeline<Mesh>::compute(DescriptorBundle<FT>& bundle) const
+{
+    if (_mesh == nullptr) {
+        throw std::runtime_error("The pipeline is not built.");
+    }
+    constexpr int hks_job = 0;
+    constexpr int wks_job = 1;
+    constexpr int spin_image_job = 2;
+    constexpr size_t spin_image_block = 1024;
+    struct Job
+    {
+        int kind;
+        size_t index;
+        size_t first;
+        size_t count;
+    };
+    Timer timer;
+    timer.tick();
+
+    // The shared data is only referenced by the descriptors
+    HKS<Mesh> hks;
+    WKS<Mesh> wks;
+    SpinImage<Mesh> spin_image;
+    if (!_hks.empty()) {
+        hks.build_squared(*_mesh, &_lambda, &_phi2);
+    }
+    if (!_wks.empty()) {
+        wks.build_squared(*_mesh, &_lambda, &_phi2);
+    }
+    if (!_spin_images.empty()) {
+        spin_image.build(*_mesh, &_vnormals, _resolution);
+    }
+
+    // Jobs in decreasing order of cost, which dynamic scheduling balances
+    std::vector<Job> jobs;
+    const auto nv = _vertices.size();
+    bundle.spin_images.resize(_spin_images.size());
+    for (size_t i = 0; i < _spin_images.size(); ++i) {
+        auto width = _spin_images[i].image_width;
+        bundle.spin_images[i].resize(width * width, nv);
+        for (size_t first = 0; first < nv; first += spin_image_block) {
+            auto count = std::min(spin_image_block, nv - first);
+            jobs.push_back(Job{spin_image_job, i, first, count});
+        }
+    }
+    bundle.hks.resize(_hks.size());
+    for (size_t i = 0; i < _hks.size(); ++i) {
+        jobs.push_back(Job{hks_job, i, 0, 0});
+    }
+    bundle.wks.resize(_wks.size());
+    for (size_t i = 0; i < _wks.size(); ++i) {
+        jobs.push_back(Job{wks_job, i, 0, 0});
+    }
+
+    std::vector<double> seconds(jobs.size());
+#pragma omp parallel for schedule(dynamic)
+    for (int j = 0; j < static_cast<int>(jobs.size()); ++j) {
+        const auto& job = jobs[j];
+        Timer job_timer;
+        job_timer.tick();
+        if (job.kind == hks_job) {
+            const auto& p = _hks[job.index];
+            hks.compute(bundle.hks[job.index], p.tscales, p.tmin, p.tmax);
+        }
+        else if (job.kind == wks_job) {
+            const auto& p = _wks[job.index];
+            wks.compute(bundle.wks[job.index],
+                        p.escales,
+                        p.emin,
+                        p.emax,
+                        p.sigma);
+        }
+        else {
+            const auto& p = _spin_images[job.index];
+            std::vector<Vertex> block(_vertices.begin() + job.first,
+                                      _vertices.begin() + job.first +
+                                          job.count);
+            typename DescriptorBundle<FT>::Array images;
+            spin_image.compute(
+                images, block, p.bin_scale, p.image_width, p.support_angle);
+            bundle.spin_images[job.index].middleCols(job.first, job.count) =
+                images;
+        }
+        seconds[j] = job_timer.tock();
+    }
+
+    // The time of a request sums up its blocks over all threads
+    bundle.timings = _timings;
+    std::vector<double> spin_image_seconds(_spin_images.size(), 0.0);
+    for (size_t j = 0; j < jobs.size(); ++j) {
+        const auto& job = jobs[j];
+        if (job.kind == spin_image_job) {
+            spin_image_seconds[job.index] += seconds[j];
+        }
+        else {
+            bundle.timings.emplace_back(
+                (job.kind == hks_job ? "hks " : "wks ") +
+                    std::to_string(job.index),
+                seconds[j]);
+        }
+    }
+    for (size_t i = 0; i < _spin_images.size(); ++i) {
+        bundle.timings.emplace_back("spin images " + std::to_string(i),
+                                    spin_image_seconds[i]);
+    }
+    bundle.timings.emplace_back("compute", timer.tock());
+}
+
+template<typename Mesh>
+const typename DescriptorPipeline<Mesh>::Vec&
+DescriptorPipeline<Mesh>::eigenvalues() const
+{
+    return _lambda;
+}
+
+template<typename Mesh>
+const std::vector<typename DescriptorPipeline<Mesh>::Vector_3>&
+DescriptorPipeline<Mesh>::vertex_normals() const
+{
+    return _vnormals;
+}
+
+template<typename Mesh>
+typename DescriptorPipeline<Mesh>::FT DescriptorPipeline<Mesh>::resolution()
+    const
+{
+    return _resolution;
+}
+
+} // namespace Euclid
@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <Euclid/Descriptor/Histogram.h>
+
+namespace Euclid
+{
+
+namespace _impl
+{
+
+// A tile of queries stays in cache while a tile of targets streams through
+constexpr Eigen::Index query_tile = 64;
+constexpr Eigen::Index target_tile = 512;
+
+template<typename DerivedA, typename DerivedB>
+void check_descriptors(const Eigen::ArrayBase<DerivedA>& queries,
+                       const Eigen::ArrayBase<DerivedB>& targets)
+{
+    static_assert(std::is_same_v<typename DerivedA::Scalar,
+                                 typename DerivedB::Scalar>,
+                  "Descriptors must have the same scalar type.");
+    if (queries.rows() != targets.rows()) {
+        throw std::invalid_argument(
+            "Descriptors must have the same dimension.");
+    }
+}
+
+// Squared norms of the descriptors, only needed by L2
+template<typename Derived>
+Eigen::Array<typename Derived::Scalar, Eigen::Dynamic, 1> squared_norms(
+    const Eigen::ArrayBase<Derived>& descriptors,
+    HistogramDistance metric)
+{
+    if (metric != HistogramDistance::l2) { return {}; }
+    return descriptors.square().colwise().sum().transpose();
+}
+
+// Distances between a tile of queries and a tile of targets
+template<typename DerivedA, typename DerivedB, typename T>
+void distance_tile(const Eigen::ArrayBase<DerivedA>& queries,
+                   const Eigen::ArrayBase<DerivedB>& targets,
+                   const Eigen::Array<T, Eigen::Dynamic, 1>& qnorms,
+                   const Eigen::Array<T, Eigen::Dynamic, 1>& tnorms,
+                   Eigen::Index qfirst,
+                   Eigen::Index qcount,
+                   Eigen::Index tfirst,
+                   Eigen::Index tcount,
+                   HistogramDistance metric,
+                   Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic>& tile)
+{
+    tile.resize(qcount, tcount);
+    auto pairwise = [&](auto&& distance) {
+        for (Eigen::Index j = 0; j < tcount; ++j) {
+            for (Eigen::Index i = 0; i < qcount; ++i) {
+                tile(i, j) = distance(queries.col(qfirst + i),
+                                      targets.col(tfirst + j));
+            }
+        }
+    };
+
+    switch (metric) {
+    case HistogramDistance::l1:
+        pairwise([](const auto& a, const auto& b) { return Euclid::l1(a, b); });
+        break;
+    case HistogramDistance::l2:
+        tile.matrix().noalias() =
+            queries.middleCols(qfirst, qcount).matrix().transpose() *
+            targets.middleCols(tfirst, tcount).matrix();
+        tile *= T(-2);
+        tile.colwise() += qnorms.segment(qfirst, qcount);
+        tile.rowwise() += tnorms.segment(tfirst, tcount).transpose();
+        // Clamp the negative values from cancellation
+        tile = tile.max(T(0)).sqrt();
+        break;
+    case HistogramDistance::chi2:
+        pairwise(
+            [](const auto& a, const auto& b) { return Euclid::chi2(a, b); });
+        break;
+    case HistogramDistance::chi2_asym:
+        pairwise([](const auto& a, const auto& b) {
+            return Euclid::chi2_asym(a, b);
+        });
+        break;
+    }
+}
+
+} // namespace _impl
+
+template<typename DerivedA, typename DerivedB, typename DerivedC>
+void distance_matrix(const Eigen::ArrayBase<DerivedA>& queries,
+                     const Eigen::ArrayBase<DerivedB>& targets,
+                     Eigen::ArrayBase<DerivedC>& distances,
+                     HistogramDistance metric)
+{
+    using T = typename DerivedA::Scalar;
+    using _impl::query_tile;
+    using _impl::target_tile;
+    _impl::check_descriptors(queries, targets);
+    const auto nq = queries.cols();
+    const auto nt = targets.cols();
+    distances.derived().resize(nq, nt);
+    const auto qnorms = _impl::squared_norms(queries, metric);
+    const auto tnorms = _impl::squared_norms(targets, metric);
+
+    const auto qtiles = (nq + query_tile - 1) / query_tile;
+    const auto ttiles = (nt + target_tile - 1) / target_tile;
+#pragma omp parallel
+    {
+        Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic> tile;
+
+#pragma omp for schedule(dynamic)
+        for (Eigen::Index t = 0; t < qtiles * ttiles; ++t) {
+            const auto qfirst = t / ttiles * query_tile;
+            const auto tfirst = t % ttiles * target_tile;
+            const auto qcount = std::min(query_tile, nq - qfirst);
+            const auto tcount = std::min(target_tile, nt - tfirst);
+            _impl::distance_tile(queries,
+                                 targets,
+                                 qnorms,
+                                 tnorms,
+                                 qfirst,
+                                 qcount,
+                                 tfirst,
+                                 tcount,
+                                 metric,
+                                 tile);
+            distances.derived().block(qfirst, tfirst, qcount, tcount) =
+                tile.template cast<typename DerivedC::Scalar>();
+        }
+    }
+}
+
+template<typename DerivedA, typename DerivedB, typename Callback>
+void distance_matrix_blocks(const Eigen::ArrayBase<DerivedA>& queries,
+                            const Eigen::ArrayBase<DerivedB>& targets,
+                            Callback&& callback,
+                            unsigned block_size,
+                            HistogramDistance metric)
+{
+    if (block_size == 0) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+    Eigen::Array<typename DerivedA::Scalar, Eigen::Dynamic, Eigen::Dynamic>
+        block;
+    for (Eigen::Index first = 0; first < queries.cols(); first += block_size) {
+        auto count = std::min<Eigen::Index>(block_size, queries.cols() - first);
+        distance_matrix(
+            queries.middleCols(first, count), targets, block, metric);
+        callback(first, block);
+    }
+}
+
+template<typename DerivedA, typename DerivedB, typename DerivedC>
+void nearest_neighbors(const Eigen::ArrayBase<DerivedA>& queries,
+                       const Eigen::ArrayBase<DerivedB>& targets,
+                       unsigned k,
+                       Eigen::ArrayXXi& indices,
+                       Eigen::ArrayBase<DerivedC>& distances,
+                       HistogramDistance metric)
+{
+    using T = typename DerivedA::Scalar;
+    using _impl::query_tile;
+    using _impl::target_tile;
+    _impl::check_descriptors(queries, targets);
+    const auto nq = queries.cols();
+    const auto nt = targets.cols();
+    if (k > nt) {
+        throw std::invalid_argument(
+            "k must not exceed the number of targets.");
+    }
+    indices.resize(k, nq);
+    distances.derived().resize(k, nq);
+    if (k == 0) { return; }
+    const auto qnorms = _impl::squared_norms(queries, metric);
+    const auto tnorms = _impl::squared_norms(targets, metric);
+
+    const auto qtiles = (nq + query_tile - 1) / query_tile;
+#pragma omp parallel
+    {
+        // A max heap of the k nearest targets per query, comparing the pairs
+        // of distance and index breaks ties by the smaller index
+        Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic> tile;
+        std::vector<std::vector<std::pair<T, int>>> heaps(query_tile);
+
+#pragma omp for schedule(dynamic)
+        for (Eigen::Index qt = 0; qt < qtiles; ++qt) {
+            const auto qfirst = qt * query_tile;
+            const auto qcount = std::min(query_tile, nq - qfirst);
+            for (Eigen::Index i = 0; i < qcount; ++i) {
+                heaps[i].clear();
+            }
+
+            for (Eigen::Index tfirst = 0; tfirst < nt; tfirst += target_tile) {
+                const auto tcount = std::min(target_tile, nt - tfirst);
+                _impl::distance_tile(queries,
+                                     targets,
+                                     qnorms,
+                                     tnorms,
+                                     qfirst,
+                                     qcount,
+                                     tfirst,
+                                     tcount,
+                                     metric,
+                                     tile);
+                for (Eigen::Index j = 0; j < tcount; ++j) {
+                    for (Eigen::Index i = 0; i < qcount; ++i) {
+                        std::pair<T, int> candidate(
+                            tile(i, j), static_cast<int>(tfirst + j));
+                        auto& heap = heaps[i];
+                        if (heap.size() < k) {
+                            heap.push_back(candidate);
+                            std::push_heap(heap.begin(), heap.end());
+                        }
+                        else if (candidate < heap.front()) {
+                            std::pop_heap(heap.begin(), heap.end());
+                            heap.back() = candidate;
+                            std::push_heap(heap.begin(), heap.end());
+                        }
+                    }
+                }
+            }
+
+            for (Eigen::Index i = 0; i < qcount; ++i) {
+                auto& heap = heaps[i];
+                std::sort_heap(heap.begin(), heap.end());
+                for (unsigned j = 0; j < k; ++j) {
+                    distances.derived()(j, qfirst + i) = heap[j].first;
+                    indices(j, qfirst + i) = heap[j].second;
+                }
+            }
+        }
+    }
+}
+
+} // namespace Euclid
@@ -16,6 +16,7 @@ void HKS<Mesh>::build(const Mesh& mesh, unsigned k)
     _lambda_min = std::abs(_emlambda(1)); // abs fix numerical error
     _emlambda = (-_emlambda).array().exp().matrix().eval();
     _phi2 = _phi2.array().square().matrix().eval();
+    _shared_phi2 = nullptr;
 }
 
 template<typename Mesh>
@@ -23,19 +24,79 @@ void HKS<Mesh>::build(const Mesh& mesh,
                       const Vec* eigenvalues,
                       const Mat* eigenfunctions)
 {
-    _mesh = &mesh;
-    _lambda_max = eigenvalues->coeff(eigenvalues->size() - 1);
-    _lambda_min = std::abs(eigenvalues->coeff(1)); // abs fix numerical error
-    _emlambda = (-*eigenvalues).array().exp().matrix().eval();
+    _build_eigenvalues(mesh, *eigenvalues);
     _phi2 = (*eigenfunctions).array().square().matrix().eval();
+    _shared_phi2 = nullptr;
+}
+
+template<typename Mesh>
+void HKS<Mesh>::build_squared(const Mesh& mesh,
+                              const Vec* eigenvalues,
+                              const Mat* squared_eigenfunctions)
+{
+    _build_eigenvalues(mesh, *eigenvalues);
+    _phi2.resize(0, 0);
+    _shared_phi2 = squared_eigenfunctions;
+}
+
+template<typename Mesh>
+template<typename Derived>
+void HKS<Mesh>::compute(Eigen::ArrayBase<Derived>& hks,
+                        unsigned tscales,
+                        float tmin,
+                        float tmax)
+{
+    auto weights = _weights(tscales, tmin, tmax);
+    auto nv = num_vertices(*_mesh);
+    hks.derived().resize(tscales, nv);
+    hks.matrix().noalias() = weights.transpose() * _squared().transpose();
 }
 
 template<typename Mesh>
 template<typename Derived>
 void HKS<Mesh>::compute(Eigen::ArrayBase<Derived>& hks,
+                        const std::vector<Vertex>& vertices,
                         unsigned tscales,
                         float tmin,
                         float tmax)
+{
+    auto weights = _weights(tscales, tmin, tmax);
+    auto vimap = get(boost::vertex_index, *_mesh);
+    Mat phi2(_squared().cols(), vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        phi2.col(i) = _squared().row(get(vimap, vertices[i])).transpose();
+    }
+    hks.derived().resize(tscales, vertices.size());
+    hks.matrix().noalias() = weights.transpose() * phi2;
+}
+
+template<typename Mesh>
+template<typename Callback>
+void HKS<Mesh>::compute_blocks(Callback&& callback,
+                               unsigned block_size,
+                               unsigned tscales,
+                               float tmin,
+                               float tmax)
+{
+    if (block_size == 0) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+    auto weights = _weights(tscales, tmin, tmax);
+    const Eigen::Index nv = _squared().rows();
+    Eigen::Array<FT, Eigen::Dynamic, Eigen::Dynamic> block;
+    for (Eigen::Index first = 0; first < nv; first += block_size) {
+        const auto n = std::min<Eigen::Index>(block_size, nv - first);
+        block.resize(tscales, n);
+        block.matrix().noalias() =
+            weights.transpose() * _squared().middleRows(first, n).transpose();
+        callback(first, block);
+    }
+}
+
+template<typename Mesh>
+typename HKS<Mesh>::Mat HKS<Mesh>::_weights(unsigned tscales,
+                                            float tmin,
+                                            float tmax) const
 {
     if (tmin > 0 && tmax > 0) {
         if (tmin >= tmax) {
@@ -50,22 +111,34 @@ void HKS<Mesh>::compute(Eigen::ArrayBase<Derived>& hks,
     auto log_tmin = std::log(tmin);
     auto log_tmax = std::log(tmax);
     auto log_tstep = (log_tmax - log_tmin) / tscales;
-    auto vimap = get(boost::vertex_index, *_mesh);
-    auto nv = num_vertices(*_mesh);
-    hks.derived().resize(tscales, nv);
 
-    for (auto v : vertices(*_mesh)) {
-        auto idx = get(vimap, v);
-        for (size_t i = 0; i < tscales; ++i) {
-            auto t = std::exp(log_tmin + log_tstep * i);
-            auto hks_t = static_cast<FT>(0);
-            for (int j = 0; j < _emlambda.size(); ++j) {
-                hks_t += std::pow(_emlambda(j), t) * _phi2(idx, j);
-            }
-            hks(i, idx) = hks_t;
+    // Weights e^{-lambda_j t_i} are shared by all vertices, and so are the
+    // normalization factors, the sums over vertices of each time scale
+    Mat weights(_emlambda.size(), tscales);
+    for (size_t i = 0; i < tscales; ++i) {
+        auto t = std::exp(log_tmin + log_tstep * i);
+        for (int j = 0; j < _emlambda.size(); ++j) {
+            weights(j, i) = std::pow(_emlambda(j), t);
         }
     }
-    hks.colwise() /= hks.rowwise().sum();
+    Vec sums = (_squared().colwise().sum() * weights).transpose();
+    weights *= sums.cwiseInverse().asDiagonal();
+    return weights;
+}
+
+template<typename Mesh>
+void HKS<Mesh>::_build_eigenvalues(const Mesh& mesh, const Vec& eigenvalues)
+{
+    _mesh = &mesh;
+    _lambda_max = eigenvalues.coeff(eigenvalues.size() - 1);
+    _lambda_min = std::abs(eigenvalues.coeff(1)); // abs fix numerical error
+    _emlambda = (-eigenvalues).array().exp().matrix().eval();
+}
+
+template<typename Mesh>
+const typename HKS<Mesh>::Mat& HKS<Mesh>::_squared() const
+{
+    return _shared_phi2 != nullptr ? *_shared_phi2 : _phi2;
 }
 
 } // namespace Euclid
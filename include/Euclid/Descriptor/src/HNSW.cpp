@@ -0,0 +1,352 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+
+#include <Euclid/Descriptor/Histogram.h>
+
+namespace Euclid
+{
+
+namespace _impl
+{
+
+// Hash an integer into a uniformly distributed one, i.e. splitmix64
+inline uint64_t hnsw_hash(uint64_t x)
+{
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+} // namespace _impl
+
+template<typename T>
+template<typename Derived>
+void HNSW<T>::build(const Eigen::ArrayBase<Derived>& descriptors,
+                    HistogramDistance metric,
+                    unsigned m,
+                    unsigned ef_construction)
+{
+    if (metric == HistogramDistance::chi2_asym) {
+        throw std::invalid_argument("Asymmetric distance is not supported.");
+    }
+    if (m < 2) { throw std::invalid_argument("m must be at least 2."); }
+    _metric = metric;
+    _m = m;
+    _ef_construction = std::max(ef_construction, m);
+    _dim = static_cast<int>(descriptors.rows());
+    _data.clear();
+    _links.clear();
+    _entry = -1;
+    _max_level = -1;
+    add(descriptors);
+}
+
+template<typename T>
+template<typename Derived>
+void HNSW<T>::add(const Eigen::ArrayBase<Derived>& descriptors)
+{
+    if (descriptors.rows() != _dim) {
+        throw std::invalid_argument(
+            "Descriptors must have the same dimension as the index.");
+    }
+    const auto first = size();
+    const auto count = static_cast<int>(descriptors.cols());
+    _data.resize(_data.size() + descriptors.size());
+    Eigen::Map<Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic>>(
+        _data.data() + static_cast<size_t>(first) * _dim, _dim, count) =
+        descriptors.template cast<T>();
+    _links.resize(first + count);
+
+    // Insertion is sequential, as every descriptor links to the previous ones
+    std::vector<unsigned> visited(size(), 0);
+    unsigned tag = 0;
+    for (int i = first; i < first + count; ++i) {
+        _insert(i, visited, tag);
+    }
+}
+
+template<typename T>
+template<typename DerivedA, typename DerivedB>
+void HNSW<T>::query(const Eigen::ArrayBase<DerivedA>& queries,
+                    unsigned k,
+                    Eigen::ArrayXXi& indices,
+                    Eigen::ArrayBase<DerivedB>& distances,
+                    unsigned ef) const
+{
+    if (queries.rows() != _dim) {
+        throw std::invalid_argument(
+            "Queries must have the same dimension as the index.");
+    }
+    if (k > static_cast<unsigned>(size())) {
+        throw std::invalid_argument("k must not exceed the size of the index.");
+    }
+    ef = std::max(k, ef == 0 ? 50u : ef);
+    const auto nq = queries.cols();
+    indices.resize(k, nq);
+    distances.derived().resize(k, nq);
+    if (k == 0) { return; }
+
+#pragma omp parallel
+    {
+        std::vector<unsigned> visited(size(), 0);
+        unsigned tag = 0;
+        std::vector<T> target(_dim);
+
+#pragma omp for schedule(dynamic, 16)
+        for (Eigen::Index i = 0; i < nq; ++i) {
+            Eigen::Map<Eigen::Array<T, Eigen::Dynamic, 1>>(target.data(),
+                                                           _dim) =
+                queries.col(i).template cast<T>();
+            std::vector<Candidate> entries{
+                {_distance(target.data(), _descriptor(_entry)), _entry}};
+            for (int level = _max_level; level > 0; --level) {
+                entries = _search_layer(
+                    target.data(), entries, 1, level, visited, tag);
+            }
+            auto nearest =
+                _search_layer(target.data(), entries, ef, 0, visited, tag);
+            for (unsigned j = 0; j < k; ++j) {
+                if (j < nearest.size()) {
+                    distances.derived()(j, i) = nearest[j].first;
+                    indices(j, i) = nearest[j].second;
+                }
+                else {
+                    distances.derived()(j, i) =
+                        std::numeric_limits<T>::infinity();
+                    indices(j, i) = -1;
+                }
+            }
+        }
+    }
+}
+
+template<typename T>
+int HNSW<T>::size() const
+{
+    return static_cast<int>(_links.size());
+}
+
+template<typename T>
+int HNSW<T>::dim() const
+{
+    return _dim;
+}
+
+template<typename T>
+template<typename Archive>
+void HNSW<T>::save(Archive& ar) const
+{
+    // The links are flattened into Eigen arrays, which are supported by
+    // Util/Serialize.h, i.e. the number of layers of every descriptor, the
+    // number of links of every layer and then all the links
+    const auto n = size();
+    Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic> data =
+        Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic>>(
+            _data.data(), _dim, n);
+    Eigen::ArrayXi layers(n);
+    std::vector<int> counts, links;
+    for (int i = 0; i < n; ++i) {
+        layers(i) = static_cast<int>(_links[i].size());
+        for (const auto& layer : _links[i]) {
+            counts.push_back(static_cast<int>(layer.size()));
+            links.insert(links.end(), layer.begin(), layer.end());
+        }
+    }
+    Eigen::ArrayXi flat_counts =
+        Eigen::Map<Eigen::ArrayXi>(counts.data(), counts.size());
+    Eigen::ArrayXi flat_links =
+        Eigen::Map<Eigen::ArrayXi>(links.data(), links.size());
+    ar(static_cast<int>(_metric),
+       _m,
+       _ef_construction,
+       _dim,
+       _entry,
+       _max_level,
+       data,
+       layers,
+       flat_counts,
+       flat_links);
+}
+
+template<typename T>
+template<typename Archive>
+void HNSW<T>::load(Archive& ar)
+{
+    int metric;
+    Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic> data;
+    Eigen::ArrayXi layers, counts, links;
+    ar(metric,
+       _m,
+       _ef_construction,
+       _dim,
+       _entry,
+       _max_level,
+       data,
+       layers,
+       counts,
+       links);
+    _metric = static_cast<HistogramDistance>(metric);
+    _data.assign(data.data(), data.data() + data.size());
+    _links.resize(layers.size());
+    Eigen::Index layer = 0, link = 0;
+    for (Eigen::Index i = 0; i < layers.size(); ++i) {
+        _links[i].resize(layers(i));
+        for (auto& l : _links[i]) {
+            l.assign(links.data() + link, links.data() + link + counts(layer));
+            link += counts(layer++);
+        }
+    }
+}
+
+template<typename T>
+const T* HNSW<T>::_descriptor(int i) const
+{
+    return _data.data() + static_cast<size_t>(i) * _dim;
+}
+
+template<typename T>
+T HNSW<T>::_distance(const T* a, const T* b) const
+{
+    Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>> d1(a, _dim);
+    Eigen::Map<const Eigen::Array<T, Eigen::Dynamic, 1>> d2(b, _dim);
+    switch (_metric) {
+    case HistogramDistance::l1: return Euclid::l1(d1, d2);
+    case HistogramDistance::l2: return Euclid::l2(d1, d2);
+    case HistogramDistance::chi2: return Euclid::chi2(d1, d2);
+    default: return Euclid::chi2_asym(d1, d2);
+    }
+}
+
+template<typename T>
+int HNSW<T>::_random_level(int i) const
+{
+    // The level is drawn from an exponential distribution with the scale
+    // 1 / ln(m), hashed from the index so that the index is reproducible
+    const auto u = std::ldexp(
+        static_cast<double>(_impl::hnsw_hash(static_cast<uint64_t>(i)) >> 11),
+        -53);
+    return static_cast<int>(-std::log(1.0 - u) / std::log(double(_m)));
+}
+
+template<typename T>
+void HNSW<T>::_insert(int i, std::vector<unsigned>& visited, unsigned& tag)
+{
+    const auto level = _random_level(i);
+    _links[i].resize(level + 1);
+    if (_entry < 0) {
+        _entry = i;
+        _max_level = level;
+        return;
+    }
+
+    // Descend greedily to the level of the new descriptor, then link it on
+    // every layer below
+    const T* target = _descriptor(i);
+    std::vector<Candidate> entries{
+        {_distance(target, _descriptor(_entry)), _entry}};
+    for (int l = _max_level; l > level; --l) {
+        entries = _search_layer(target, entries, 1, l, visited, tag);
+    }
+    for (int l = std::min(level, _max_level); l >= 0; --l) {
+        auto candidates =
+            _search_layer(target, entries, _ef_construction, l, visited, tag);
+        const auto max_links = l == 0 ? 2 * _m : _m;
+        _links[i][l] = _select(candidates, _m);
+        for (auto j : _links[i][l]) {
+            auto& links = _links[j][l];
+            links.push_back(i);
+            if (links.size() > max_links) {
+                std::vector<Candidate> neighbors;
+                neighbors.reserve(links.size());
+                for (auto n : links) {
+                    neighbors.emplace_back(
+                        _distance(_descriptor(j), _descriptor(n)), n);
+                }
+                links = _select(std::move(neighbors), max_links);
+            }
+        }
+        entries = std::move(candidates);
+    }
+    if (level > _max_level) {
+        _entry = i;
+        _max_level = level;
+    }
+}
+
+template<typename T>
+std::vector<typename HNSW<T>::Candidate> HNSW<T>::_search_layer(
+    const T* target,
+    const std::vector<Candidate>& entries,
+    unsigned ef,
+    int level,
+    std::vector<unsigned>& visited,
+    unsigned& tag) const
+{
+    // Visited descriptors are marked with the tag of the current search, so
+    // the marks are only cleared when the tag wraps around
+    if (++tag == 0) {
+        std::fill(visited.begin(), visited.end(), 0);
+        tag = 1;
+    }
+
+    // Expand the closest candidate until it is farther than all of the ef
+    // nearest descriptors found
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>>
+        frontier;
+    std::priority_queue<Candidate> nearest;
+    for (const auto& entry : entries) {
+        visited[entry.second] = tag;
+        frontier.push(entry);
+        nearest.push(entry);
+        if (nearest.size() > ef) { nearest.pop(); }
+    }
+    while (!frontier.empty()) {
+        auto candidate = frontier.top();
+        if (candidate.first > nearest.top().first) { break; }
+        frontier.pop();
+        for (auto j : _links[candidate.second][level]) {
+            if (visited[j] == tag) { continue; }
+            visited[j] = tag;
+            auto distance = _distance(target, _descriptor(j));
+            if (nearest.size() < ef || distance < nearest.top().first) {
+                frontier.emplace(distance, j);
+                nearest.emplace(distance, j);
+                if (nearest.size() > ef) { nearest.pop(); }
+            }
+        }
+    }
+
+    std::vector<Candidate> result(nearest.size());
+    for (auto it = result.rbegin(); it != result.rend(); ++it) {
+        *it = nearest.top();
+        nearest.pop();
+    }
+    return result;
+}
+
+template<typename T>
+std::vector<int> HNSW<T>::_select(std::vector<Candidate> candidates,
+                                  unsigned count) const
+{
+    // Keep a candidate only if it is closer to the target than to all the
+    // kept ones, which spreads the links in different directions
+    std::sort(candidates.begin(), candidates.end());
+    std::vector<int> result;
+    for (const auto& candidate : candidates) {
+        if (result.size() >= count) { break; }
+        const T* p = _descriptor(candidate.second);
+        auto keep = std::none_of(result.begin(), result.end(), [&](int r) {
+            return _distance(p, _descriptor(r)) < candidate.first;
+        });
+        if (keep) { result.push_back(candidate.second); }
+    }
+    return result;
+}
+
+} // namespace Euclid
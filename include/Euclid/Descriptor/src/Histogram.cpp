@@ -1,9 +1,48 @@
 #include <cmath>
+#include <limits>
 #include <numeric>
 
 namespace Euclid
 {
 
+namespace _impl
+{
+
+// Call f(a, b) for every index where either sparse vector is nonzero, the
+// indices where both are zero contribute nothing to the distances
+template<typename DerivedA, typename DerivedB, typename F>
+void merge_nonzeros(const Eigen::SparseCompressedBase<DerivedA>& d1,
+                    const Eigen::SparseCompressedBase<DerivedB>& d2,
+                    F&& f)
+{
+    using T = typename DerivedA::Scalar;
+    typename Eigen::SparseCompressedBase<DerivedA>::InnerIterator it1(d1, 0);
+    typename Eigen::SparseCompressedBase<DerivedB>::InnerIterator it2(d2, 0);
+    while (it1 && it2) {
+        if (it1.index() < it2.index()) {
+            f(it1.value(), T(0));
+            ++it1;
+        }
+        else if (it2.index() < it1.index()) {
+            f(T(0), it2.value());
+            ++it2;
+        }
+        else {
+            f(it1.value(), it2.value());
+            ++it1;
+            ++it2;
+        }
+    }
+    for (; it1; ++it1) {
+        f(it1.value(), T(0));
+    }
+    for (; it2; ++it2) {
+        f(T(0), it2.value());
+    }
+}
+
+} // namespace _impl
+
 template<typename DerivedA, typename DerivedB, typename T, typename>
 T l1(const Eigen::ArrayBase<DerivedA>& d1, const Eigen::ArrayBase<DerivedB>& d2)
 {
@@ -31,4 +70,72 @@ T chi2_asym(const Eigen::ArrayBase<DerivedA>& d1,
     return ((d1 - d2).square() / (d1 + std::numeric_limits<T>::min())).sum();
 }
 
+// The quantized elements are converted to float on the fly, in the same pass
+// as the distance, and never stored in full precision
+
+template<typename T>
+float l1(const QuantizedRef<T>& d1, const QuantizedRef<T>& d2)
+{
+    return l1(d1.array(), d2.array());
+}
+
+template<typename T>
+float l2(const QuantizedRef<T>& d1, const QuantizedRef<T>& d2)
+{
+    return l2(d1.array(), d2.array());
+}
+
+template<typename T>
+float chi2(const QuantizedRef<T>& d1, const QuantizedRef<T>& d2)
+{
+    return chi2(d1.array(), d2.array());
+}
+
+template<typename T>
+float chi2_asym(const QuantizedRef<T>& d1, const QuantizedRef<T>& d2)
+{
+    return chi2_asym(d1.array(), d2.array());
+}
+
+template<typename DerivedA, typename DerivedB, typename T, typename>
+T l1(const Eigen::SparseCompressedBase<DerivedA>& d1,
+     const Eigen::SparseCompressedBase<DerivedB>& d2)
+{
+    T sum = 0;
+    _impl::merge_nonzeros(d1, d2, [&](T a, T b) { sum += std::abs(a - b); });
+    return sum;
+}
+
+template<typename DerivedA, typename DerivedB, typename T, typename>
+T l2(const Eigen::SparseCompressedBase<DerivedA>& d1,
+     const Eigen::SparseCompressedBase<DerivedB>& d2)
+{
+    T sum = 0;
+    _impl::merge_nonzeros(
+        d1, d2, [&](T a, T b) { sum += (a - b) * (a - b); });
+    return std::sqrt(sum);
+}
+
+template<typename DerivedA, typename DerivedB, typename T, typename>
+T chi2(const Eigen::SparseCompressedBase<DerivedA>& d1,
+       const Eigen::SparseCompressedBase<DerivedB>& d2)
+{
+    T sum = 0;
+    _impl::merge_nonzeros(d1, d2, [&](T a, T b) {
+        sum += (a - b) * (a - b) / (a + b + std::numeric_limits<T>::min());
+    });
+    return 2 * sum;
+}
+
+template<typename DerivedA, typename DerivedB, typename T, typename>
+T chi2_asym(const Eigen::SparseCompressedBase<DerivedA>& d1,
+            const Eigen::SparseCompressedBase<DerivedB>& d2)
+{
+    T sum = 0;
+    _impl::merge_nonzeros(d1, d2, [&](T a, T b) {
+        sum += (a - b) * (a - b) / (a + std::numeric_limits<T>::min());
+    });
+    return sum;
+}
+
 } // namespace Euclid
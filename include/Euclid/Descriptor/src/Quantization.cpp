@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace Euclid
+{
+
+template<typename T>
+QuantizedDescriptors<T>::QuantizedDescriptors(Eigen::Index dim,
+                                              Eigen::Index count)
+{
+    resize(dim, count);
+}
+
+template<typename T>
+template<typename Derived>
+QuantizedDescriptors<T>::QuantizedDescriptors(
+    const Eigen::ArrayBase<Derived>& descriptors)
+{
+    resize(descriptors.rows(), descriptors.cols());
+    set(0, descriptors);
+}
+
+template<typename T>
+void QuantizedDescriptors<T>::resize(Eigen::Index dim, Eigen::Index count)
+{
+    _data.resize(dim, count);
+    if constexpr (scaled) {
+        _scales.resize(count);
+    }
+}
+
+template<typename T>
+template<typename Derived>
+void QuantizedDescriptors<T>::set(Eigen::Index first,
+                                  const Eigen::ArrayBase<Derived>& block)
+{
+    if (block.rows() != _data.rows() || first < 0 ||
+        first + block.cols() > _data.cols()) {
+        throw std::invalid_argument("Block is out of the storage range.");
+    }
+    if constexpr (std::is_same_v<T, int8_t>) {
+        // Symmetric quantization, the largest magnitude maps to 127
+        for (Eigen::Index j = 0; j < block.cols(); ++j) {
+            const auto vmax =
+                static_cast<float>(block.col(j).abs().maxCoeff());
+            const auto scale = vmax / 127.0f;
+            _scales(first + j) = scale;
+            const auto inv = scale == 0.0f ? 0.0f : 1.0f / scale;
+            for (Eigen::Index i = 0; i < block.rows(); ++i) {
+                auto q = std::round(static_cast<float>(block(i, j)) * inv);
+                _data(i, first + j) =
+                    static_cast<int8_t>(std::clamp(q, -127.0f, 127.0f));
+            }
+        }
+    }
+    else if constexpr (scaled) {
+        for (Eigen::Index j = 0; j < block.cols(); ++j) {
+            const auto scale =
+                static_cast<float>(block.col(j).abs().maxCoeff());
+            _scales(first + j) = scale;
+            const auto inv = scale == 0.0f ? 0.0f : 1.0f / scale;
+            _data.col(first + j) =
+                (block.col(j).template cast<float>() * inv).template cast<T>();
+        }
+    }
+    else {
+        _data.middleCols(first, block.cols()) =
+            block.template cast<float>().template cast<T>();
+    }
+}
+
+template<typename T>
+template<typename Derived>
+void QuantizedDescriptors<T>::dequantize(
+    Eigen::ArrayBase<Derived>& descriptors) const
+{
+    using Scalar = typename Derived::Scalar;
+    descriptors.derived().resize(_data.rows(), _data.cols());
+    descriptors = _data.template cast<float>().template cast<Scalar>();
+    if constexpr (scaled) {
+        descriptors.rowwise() *=
+            _scales.template cast<Scalar>().transpose().eval();
+    }
+}
+
+template<typename T>
+QuantizedRef<T> QuantizedDescriptors<T>::col(Eigen::Index i) const
+{
+    float scale = 1.0f;
+    if constexpr (scaled) {
+        scale = _scales(i);
+    }
+    return QuantizedRef<T>{_data.col(i).data(), _data.rows(), scale};
+}
+
+template<typename T>
+Eigen::Index QuantizedDescriptors<T>::rows() const
+{
+    return _data.rows();
+}
+
+template<typename T>
+Eigen::Index QuantizedDescriptors<T>::cols() const
+{
+    return _data.cols();
+}
+
+template<typename T>
+const typename QuantizedDescriptors<T>::Data& QuantizedDescriptors<T>::data()
+    const
+{
+    return _data;
+}
+
+template<typename T>
+const typename QuantizedDescriptors<T>::Scales&
+QuantizedDescriptors<T>::scales() const
+{
+    return _scales;
+}
+
+template<typename T>
+std::size_t QuantizedDescriptors<T>::bytes() const
+{
+    return _data.size() * sizeof(T) + _scales.size() * sizeof(float);
+}
+
+} // namespace Euclid
@@ -1,4 +1,9 @@
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
 #include <tuple>
 #include <unordered_map>
 
@@ -9,6 +14,113 @@
 namespace Euclid
 {
 
+namespace _impl
+{
+
+// Points bucketed into a uniform grid of cubic cells. The points are sorted by
+// the keys of their cells, which run along x first, so that every row of cells
+// along x is a contiguous range of the sorted order found by binary search.
+template<typename Point_3>
+class PointGrid
+{
+public:
+    using FT = typename CGAL::Kernel_traits<Point_3>::Kernel::FT;
+
+    void build(const std::vector<Point_3>& points, FT cell_size)
+    {
+        _keys.clear();
+        _indices.clear();
+        if (points.empty()) { return; }
+        _min = {points[0].x(), points[0].y(), points[0].z()};
+        FT extent = 0;
+        for (const auto& p : points) {
+            _min[0] = std::min(_min[0], p.x());
+            _min[1] = std::min(_min[1], p.y());
+            _min[2] = std::min(_min[2], p.z());
+        }
+        for (const auto& p : points) {
+            extent = std::max({extent,
+                               p.x() - _min[0],
+                               p.y() - _min[1],
+                               p.z() - _min[2]});
+        }
+        // Keep the cell coordinates within the bits of a key
+        _cell = std::max(cell_size, extent / (_max_coord - 1));
+        if (!(_cell > 0)) { _cell = 1; }
+
+        std::vector<uint64_t> keys(points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            const auto& p = points[i];
+            keys[i] =
+                _key(_coord(p.x(), 0), _coord(p.y(), 1), _coord(p.z(), 2));
+        }
+        std::vector<int> order(points.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return keys[a] < keys[b];
+        });
+        _keys.resize(points.size());
+        for (size_t i = 0; i < order.size(); ++i) {
+            _keys[i] = keys[order[i]];
+        }
+        _indices.swap(order);
+    }
+
+    // Indices of the points in the sorted order
+    const std::vector<int>& indices() const
+    {
+        return _indices;
+    }
+
+    // Call f(first, last) for every range of the sorted order in the cells
+    // overlapping the box around the center, which contains all the points
+    // within the radius
+    template<typename F>
+    void query(const Point_3& center, FT radius, F&& f) const
+    {
+        const FT c[3] = {center.x(), center.y(), center.z()};
+        uint64_t lo[3], hi[3];
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = _coord(c[k] - radius, k);
+            hi[k] = _coord(c[k] + radius, k);
+        }
+        for (auto z = lo[2]; z <= hi[2]; ++z) {
+            for (auto y = lo[1]; y <= hi[1]; ++y) {
+                auto first = std::lower_bound(
+                    _keys.begin(), _keys.end(), _key(lo[0], y, z));
+                auto last =
+                    std::upper_bound(first, _keys.end(), _key(hi[0], y, z));
+                if (first != last) {
+                    f(first - _keys.begin(), last - _keys.begin());
+                }
+            }
+        }
+    }
+
+private:
+    uint64_t _coord(FT v, int axis) const
+    {
+        const FT c = std::floor((v - _min[axis]) / _cell);
+        if (!(c > 0)) { return 0; }
+        if (c >= _max_coord) { return _max_coord - 1; }
+        return static_cast<uint64_t>(c);
+    }
+
+    static uint64_t _key(uint64_t x, uint64_t y, uint64_t z)
+    {
+        return (z << 42) | (y << 21) | x;
+    }
+
+private:
+    static constexpr uint64_t _max_coord = uint64_t(1) << 21;
+    std::array<FT, 3> _min;
+    FT _cell = 1;
+    std::vector<uint64_t> _keys;
+    std::vector<int> _indices;
+};
+
+} // namespace _impl
+
 template<typename Mesh>
 void SpinImage<Mesh>::build(const Mesh& mesh,
                             const std::vector<Vector_3>* vnormals,
@@ -31,11 +143,42 @@ void SpinImage<Mesh>::build(const Mesh& mesh,
         }
         this->resolution /= static_cast<FT>(num_edges(mesh));
     }
+
+    // The default support spans about 17 resolutions, so cells of 8 keep both
+    // the rows searched and the points visited outside the support few
+    auto vpmap = get(boost::vertex_point, mesh);
+    auto vertices = _vertices();
+    std::vector<Point_3> points;
+    points.reserve(vertices.size());
+    for (auto v : vertices) {
+        points.push_back(get(vpmap, v));
+    }
+    _grid.build(points, 8 * this->resolution);
+
+    // Positions and normals are laid out in the grid order for SIMD access
+    const auto& order = _grid.indices();
+    _attributes.resize(order.size(), 6);
+    for (size_t i = 0; i < order.size(); ++i) {
+        const auto& p = points[order[i]];
+        const auto& n = (*this->vnormals)[order[i]];
+        _attributes.row(i) << p.x(), p.y(), p.z(), n.x(), n.y(), n.z();
+    }
+}
+
+template<typename Mesh>
+template<typename Derived>
+void SpinImage<Mesh>::compute(Eigen::ArrayBase<Derived>& spin_img,
+                              float bin_scale,
+                              int image_width,
+                              float support_angle)
+{
+    compute(spin_img, _vertices(), bin_scale, image_width, support_angle);
 }
 
 template<typename Mesh>
 template<typename Derived>
 void SpinImage<Mesh>::compute(Eigen::ArrayBase<Derived>& spin_img,
+                              const std::vector<Vertex>& subset,
                               float bin_scale,
                               int image_width,
                               float support_angle)
@@ -47,41 +190,181 @@ void SpinImage<Mesh>::compute(Eigen::ArrayBase<Derived>& spin_img,
     auto bin_size = this->resolution * static_cast<FT>(bin_scale);
     auto support_distance = bin_size * image_width;
     auto beta_max = support_distance * 0.5;
-    spin_img.derived().setZero(image_width * image_width,
-                               num_vertices(*this->mesh));
-
-    for (auto vi : vertices(*this->mesh)) {
-        auto ii = get(vimap, vi);
-        auto pi = get(vpmap, vi);
-        auto ni = (*this->vnormals)[ii];
-
-        // Find all vertices that lie in the support and compute the spin image
-        for (auto vj : vertices(*this->mesh)) {
-            auto ij = get(vimap, vj);
-            auto pj = get(vpmap, vj);
-
-            if (ni * (*this->vnormals)[ij] < cos_range) { continue; }
-
-            auto beta = ni * (pj - pi);
-            auto alpha = std::sqrt((pj - pi).squared_length() - beta * beta);
-
-            auto col = static_cast<int>(std::floor(alpha / bin_size));
-            if (col > image_width - 2) { continue; }
-            auto row =
-                static_cast<int>(std::floor((beta_max - beta) / bin_size));
-            if (row > image_width - 2 || row < 0) { continue; }
-
-            // Bilinear interpolation
-            auto a = alpha / bin_size - col;
-            auto b = beta_max / bin_size - beta / bin_size - row;
-            EASSERT(a <= 1.0 && a >= 0.0);
-            EASSERT(b <= 1.0 && b >= 0.0);
-            spin_img(row * image_width + col, ii) += (1.0f - a) * (1.0f - b);
-            spin_img(row * image_width + col + 1, ii) += a * (1.0f - b);
-            spin_img((row + 1) * image_width + col, ii) += (1.0f - a) * b;
-            spin_img((row + 1) * image_width + col + 1, ii) += a * b;
+    spin_img.derived().resize(image_width * image_width, subset.size());
+
+    // Accepted points are less than image_width - 1 bins away along the image
+    // and image_width / 2 bins across, the rest are rejected by the binning
+    // below anyway, which is kept as is so that the images are exactly those
+    // from all vertices
+    const auto w = static_cast<FT>(image_width);
+    const auto radius =
+        1.01 * bin_size * std::sqrt((w - 1) * (w - 1) + w * w / 4);
+    const auto& order = _grid.indices();
+    const FT* x = _attributes.col(0).data();
+    const FT* y = _attributes.col(1).data();
+    const FT* z = _attributes.col(2).data();
+    const FT* nx = _attributes.col(3).data();
+    const FT* ny = _attributes.col(4).data();
+    const FT* nz = _attributes.col(5).data();
+
+#pragma omp parallel
+    {
+        // Per-thread scratch, the image is accumulated here and stored to its
+        // column at once
+        Eigen::Array<FT, Eigen::Dynamic, 1> image(image_width * image_width);
+        std::vector<FT> alphas, betas, cosines;
+        std::vector<std::tuple<int, FT, FT>> support;
+
+#pragma omp for schedule(dynamic, 16)
+        for (int k = 0; k < static_cast<int>(subset.size()); ++k) {
+            auto vi = subset[k];
+            auto pi = get(vpmap, vi);
+            auto ni = (*this->vnormals)[get(vimap, vi)];
+            const FT px = pi.x(), py = pi.y(), pz = pi.z();
+            const FT mx = ni.x(), my = ni.y(), mz = ni.z();
+
+            // Projections of the vertices near the support, computed on the
+            // contiguous ranges of the grid with the same operations as
+            // vector arithmetic so that the values are the same. The square
+            // roots are taken in a separate loop, std::sqrt keeps a loop from
+            // being vectorized as it may set errno, while the vectorized one
+            // of Eigen is not always correctly rounded.
+            support.clear();
+            _grid.query(pi, radius, [&](auto first, auto last) {
+                const auto n = last - first;
+                alphas.resize(n);
+                betas.resize(n);
+                cosines.resize(n);
+#pragma omp simd
+                for (Eigen::Index j = 0; j < n; ++j) {
+                    const auto dx = x[first + j] - px;
+                    const auto dy = y[first + j] - py;
+                    const auto dz = z[first + j] - pz;
+                    const auto beta = mx * dx + my * dy + mz * dz;
+                    const auto length2 = dx * dx + dy * dy + dz * dz;
+                    cosines[j] = mx * nx[first + j] + my * ny[first + j] +
+                                 mz * nz[first + j];
+                    betas[j] = beta;
+                    alphas[j] = length2 - beta * beta;
+                }
+                for (Eigen::Index j = 0; j < n; ++j) {
+                    alphas[j] = std::sqrt(alphas[j]);
+                }
+                for (Eigen::Index j = 0; j < n; ++j) {
+                    if (cosines[j] < cos_range) { continue; }
+                    auto col =
+                        static_cast<int>(std::floor(alphas[j] / bin_size));
+                    if (col > image_width - 2) { continue; }
+                    auto row = static_cast<int>(
+                        std::floor((beta_max - betas[j]) / bin_size));
+                    if (row > image_width - 2 || row < 0) { continue; }
+                    support.emplace_back(order[first + j], alphas[j], betas[j]);
+                }
+            });
+
+            // Accumulate in the order of the vertex indices as the order of
+            // summation changes the result
+            std::sort(support.begin(),
+                      support.end(),
+                      [](const auto& a, const auto& b) {
+                          return std::get<0>(a) < std::get<0>(b);
+                      });
+            image.setZero();
+            for (const auto& [ij, alpha, beta] : support) {
+                auto col = static_cast<int>(std::floor(alpha / bin_size));
+                auto row =
+                    static_cast<int>(std::floor((beta_max - beta) / bin_size));
+
+                // Bilinear interpolation
+                auto a = alpha / bin_size - col;
+                auto b = beta_max / bin_size - beta / bin_size - row;
+                EASSERT(a <= 1.0 && a >= 0.0);
+                EASSERT(b <= 1.0 && b >= 0.0);
+                image(row * image_width + col) += (1.0f - a) * (1.0f - b);
+                image(row * image_width + col + 1) += a * (1.0f - b);
+                image((row + 1) * image_width + col) += (1.0f - a) * b;
+                image((row + 1) * image_width + col + 1) += a * b;
+            }
+            spin_img.col(k) =
+                image.template cast<typename Derived::Scalar>();
         }
     }
 }
 
+template<typename Mesh>
+template<typename T>
+void SpinImage<Mesh>::compute(Eigen::SparseMatrix<T>& spin_img,
+                              float bin_scale,
+                              int image_width,
+                              float support_angle)
+{
+    compute(spin_img, _vertices(), bin_scale, image_width, support_angle);
+}
+
+template<typename Mesh>
+template<typename T>
+void SpinImage<Mesh>::compute(Eigen::SparseMatrix<T>& spin_img,
+                              const std::vector<Vertex>& subset,
+                              float bin_scale,
+                              int image_width,
+                              float support_angle)
+{
+    // Blocks large enough to keep the threads busy, the nonzeros of each
+    // column are appended in order
+    const size_t block_size = 1024;
+    const auto bins = image_width * image_width;
+    spin_img.resize(bins, subset.size());
+    Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic> block;
+    std::vector<Vertex> part;
+    for (size_t first = 0; first < subset.size(); first += block_size) {
+        auto last = std::min(subset.size(), first + block_size);
+        part.assign(subset.begin() + first, subset.begin() + last);
+        compute(block, part, bin_scale, image_width, support_angle);
+        for (Eigen::Index j = 0; j < block.cols(); ++j) {
+            spin_img.startVec(first + j);
+            for (int i = 0; i < bins; ++i) {
+                if (block(i, j) != 0) {
+                    spin_img.insertBack(i, first + j) = block(i, j);
+                }
+            }
+        }
+    }
+    spin_img.finalize();
+}
+
+template<typename Mesh>
+template<typename Callback>
+void SpinImage<Mesh>::compute_blocks(Callback&& callback,
+                                     unsigned block_size,
+                                     float bin_scale,
+                                     int image_width,
+                                     float support_angle)
+{
+    if (block_size == 0) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+    auto all = _vertices();
+    std::vector<Vertex> part;
+    Eigen::Array<FT, Eigen::Dynamic, Eigen::Dynamic> block;
+    for (size_t first = 0; first < all.size(); first += block_size) {
+        auto last = std::min(all.size(), first + block_size);
+        part.assign(all.begin() + first, all.begin() + last);
+        compute(block, part, bin_scale, image_width, support_angle);
+        callback(static_cast<Eigen::Index>(first), block);
+    }
+}
+
+template<typename Mesh>
+std::vector<typename SpinImage<Mesh>::Vertex> SpinImage<Mesh>::_vertices()
+    const
+{
+    // Vertices in the order of their indices, i.e. the output columns
+    auto vimap = get(boost::vertex_index, *this->mesh);
+    std::vector<Vertex> result(num_vertices(*this->mesh));
+    for (auto v : vertices(*this->mesh)) {
+        result[get(vimap, v)] = v;
+    }
+    return result;
+}
+
 } // namespace Euclid
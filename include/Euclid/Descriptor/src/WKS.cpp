@@ -18,6 +18,7 @@ void WKS<Mesh>::build(const Mesh& mesh, unsigned k)
     _lambda_min = std::abs(_loglambda(1));
     _loglambda = _loglambda.array().abs().log().matrix().eval();
     _phi2 = _phi2.array().square().matrix().eval();
+    _shared_phi2 = nullptr;
 }
 
 template<typename Mesh>
@@ -25,12 +26,19 @@ void WKS<Mesh>::build(const Mesh& mesh,
                       const Vec* eigenvalues,
                       const Mat* eigenfunctions)
 {
-    _mesh = &mesh;
-    // abs fix numerical error
-    _lambda_max = std::abs(eigenvalues->coeff(eigenvalues->size() - 1));
-    _lambda_min = std::abs(eigenvalues->coeff(1));
-    _loglambda = (*eigenvalues).array().abs().log().matrix().eval();
+    _build_eigenvalues(mesh, *eigenvalues);
     _phi2 = (*eigenfunctions).array().square().matrix().eval();
+    _shared_phi2 = nullptr;
+}
+
+template<typename Mesh>
+void WKS<Mesh>::build_squared(const Mesh& mesh,
+                              const Vec* eigenvalues,
+                              const Mat* squared_eigenfunctions)
+{
+    _build_eigenvalues(mesh, *eigenvalues);
+    _phi2.resize(0, 0);
+    _shared_phi2 = squared_eigenfunctions;
 }
 
 template<typename Mesh>
@@ -40,6 +48,69 @@ void WKS<Mesh>::compute(Eigen::ArrayBase<Derived>& wks,
                         float emin,
                         float emax,
                         float sigma)
+{
+    auto filters = _filters(escales, emin, emax, sigma);
+    auto nv = num_vertices(*_mesh);
+
+    // Blocks of vertices keep the operands of each product in cache, and the
+    // products are written in place without temporaries
+    constexpr Eigen::Index block = 4096;
+    wks.derived().resize(escales, nv);
+    for (Eigen::Index first = 0; first < _squared().rows(); first += block) {
+        const auto n = std::min(block, _squared().rows() - first);
+        wks.matrix().middleCols(first, n).noalias() =
+            filters.transpose() * _squared().middleRows(first, n).transpose();
+    }
+}
+
+template<typename Mesh>
+template<typename Derived>
+void WKS<Mesh>::compute(Eigen::ArrayBase<Derived>& wks,
+                        const std::vector<Vertex>& vertices,
+                        unsigned escales,
+                        float emin,
+                        float emax,
+                        float sigma)
+{
+    auto filters = _filters(escales, emin, emax, sigma);
+    auto vimap = get(boost::vertex_index, *_mesh);
+    Mat phi2(_squared().cols(), vertices.size());
+    for (size_t i = 0; i < vertices.size(); ++i) {
+        phi2.col(i) = _squared().row(get(vimap, vertices[i])).transpose();
+    }
+    wks.derived().resize(escales, vertices.size());
+    wks.matrix().noalias() = filters.transpose() * phi2;
+}
+
+template<typename Mesh>
+template<typename Callback>
+void WKS<Mesh>::compute_blocks(Callback&& callback,
+                               unsigned block_size,
+                               unsigned escales,
+                               float emin,
+                               float emax,
+                               float sigma)
+{
+    if (block_size == 0) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+    auto filters = _filters(escales, emin, emax, sigma);
+    const Eigen::Index nv = _squared().rows();
+    Eigen::Array<FT, Eigen::Dynamic, Eigen::Dynamic> block;
+    for (Eigen::Index first = 0; first < nv; first += block_size) {
+        const auto n = std::min<Eigen::Index>(block_size, nv - first);
+        block.resize(escales, n);
+        block.matrix().noalias() =
+            filters.transpose() * _squared().middleRows(first, n).transpose();
+        callback(first, block);
+    }
+}
+
+template<typename Mesh>
+typename WKS<Mesh>::Mat WKS<Mesh>::_filters(unsigned escales,
+                                            float emin,
+                                            float emax,
+                                            float sigma) const
 {
     if (emin >= emax || sigma <= 0) {
         // the parameters described in paper form a linear system
@@ -57,24 +128,36 @@ void WKS<Mesh>::compute(Eigen::ArrayBase<Derived>& wks,
     }
     auto estep = (emax - emin) / escales;
     auto edenom = 0.5f / (sigma * sigma);
-    auto vimap = get(boost::vertex_index, *_mesh);
-    auto nv = num_vertices(*_mesh);
-    wks.derived().resize(escales, nv);
 
-    for (auto v : vertices(*_mesh)) {
-        auto idx = get(vimap, v);
-        for (size_t i = 0; i < escales; ++i) {
-            auto e = emin + estep * i;
-            auto wks_e = static_cast<FT>(0);
-            auto ce = static_cast<FT>(0);
-            for (int j = 1; j < _loglambda.size(); ++j) {
-                auto exp = std::exp(-std::pow(e - _loglambda(j), 2) * edenom);
-                ce += exp;
-                wks_e += exp * _phi2(idx, j);
-            }
-            wks(i, idx) = wks_e / ce;
+    // The energy filters don't depend on the vertex, so they are evaluated
+    // once and normalized by their sums over the eigenvalues, the first one
+    // is excluded as in the paper
+    Mat filters = Mat::Zero(_loglambda.size(), escales);
+    for (size_t i = 0; i < escales; ++i) {
+        auto e = emin + estep * i;
+        for (int j = 1; j < _loglambda.size(); ++j) {
+            filters(j, i) = std::exp(-std::pow(e - _loglambda(j), 2) * edenom);
         }
     }
+    Vec sums = filters.colwise().sum().transpose();
+    filters *= sums.cwiseInverse().asDiagonal();
+    return filters;
+}
+
+template<typename Mesh>
+void WKS<Mesh>::_build_eigenvalues(const Mesh& mesh, const Vec& eigenvalues)
+{
+    _mesh = &mesh;
+    // abs fix numerical error
+    _lambda_max = std::abs(eigenvalues.coeff(eigenvalues.size() - 1));
+    _lambda_min = std::abs(eigenvalues.coeff(1));
+    _loglambda = eigenvalues.array().abs().log().matrix().eval();
+}
+
+template<typename Mesh>
+const typename WKS<Mesh>::Mat& WKS<Mesh>::_squared() const
+{
+    return _shared_phi2 != nullptr ? *_shared_phi2 : _phi2;
 }
 
 } // namespace Euclid
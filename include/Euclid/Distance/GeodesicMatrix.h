@@ -0,0 +1,96 @@
+/** Geodesic distance matrices written to disk.
+ *
+ *  The distances between all pairs of vertices, or from a set of landmarks
+ *  to all vertices, are computed by the heat method and written to a raw
+ *  binary file in row-major order, one row per source and one column per
+ *  vertex, without any header. The file is meant to be memory mapped by the
+ *  consumer, e.g. numpy.memmap, so that the matrix of a large mesh never has
+ *  to fit in memory.
+ *
+ *  The sources are solved in blocks with one right-hand side per source, and
+ *  the blocks run in parallel if OpenMP is enabled, all threads sharing the
+ *  factors of the heat method. Each thread holds the dense intermediate
+ *  matrices of one block, a few times the number of vertices times the block
+ *  size, see GeodesicsInHeat::compute_batch.
+ *
+ *  The file is written through a memory mapping as well, each block of rows
+ *  being copied in one go. The heat method isn't exactly symmetric, so the
+ *  all-pairs matrix is symmetrized afterwards by averaging each pair of
+ *  transposed entries, tile by tile in the mapped memory.
+ *
+ *  @defgroup PkgGeodesicMatrix GeodesicMatrix
+ *  @ingroup PkgDistance
+ */
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Euclid/Distance/GeodesicsInHeat.h>
+
+namespace Euclid
+{
+/** @{*/
+
+/** The scalar type of a geodesic matrix file.
+ *
+ */
+enum class GeodesicPrecision
+{
+    /** IEEE single precision, 4 bytes per distance. */
+    float32,
+
+    /** IEEE half precision, 2 bytes per distance, i.e. Eigen::half. */
+    float16
+};
+
+/** Write the geodesic distances between all pairs of vertices to a file.
+ *
+ *  Row i of the matrix holds the distances from the vertex of index i, and
+ *  the matrix is symmetrized.
+ *
+ *  @param heat_method The heat method, already built.
+ *  @param filename The output file, overwritten if it exists.
+ *  @param precision The scalar type of the file.
+ *  @param block_size Number of sources solved together by a thread.
+ *  @param progress If provided, called as progress(done, total) after each
+ *  block with the number of sources solved so far, from one thread at a
+ *  time.
+ */
+template<typename Mesh>
+void geodesic_matrix(
+    const GeodesicsInHeat<Mesh>& heat_method,
+    const std::string& filename,
+    GeodesicPrecision precision = GeodesicPrecision::float32,
+    unsigned block_size = 32,
+    const std::function<void(size_t, size_t)>& progress = nullptr);
+
+/** Write the geodesic distances from a set of landmarks to a file.
+ *
+ *  Row i of the matrix holds the distances from landmark i to all vertices.
+ *  The matrix isn't square and isn't symmetrized.
+ *
+ *  @param heat_method The heat method, already built.
+ *  @param landmarks The source vertices.
+ *  @param filename The output file, overwritten if it exists.
+ *  @param precision The scalar type of the file.
+ *  @param block_size Number of sources solved together by a thread.
+ *  @param progress If provided, called as progress(done, total) after each
+ *  block with the number of sources solved so far, from one thread at a
+ *  time.
+ */
+template<typename Mesh>
+void geodesic_matrix(
+    const GeodesicsInHeat<Mesh>& heat_method,
+    const std::vector<typename GeodesicsInHeat<Mesh>::Vertex>& landmarks,
+    const std::string& filename,
+    GeodesicPrecision precision = GeodesicPrecision::float32,
+    unsigned block_size = 32,
+    const std::function<void(size_t, size_t)>& progress = nullptr);
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/GeodesicMatrix.cpp"
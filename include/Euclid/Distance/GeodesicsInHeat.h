@@ -1,8 +1,11 @@
 #pragma once
 
+#include <list>
+#include <utility>
 #include <vector>
 #include <CGAL/boost/graph/properties.h>
 #include <CGAL/Kernel_traits.h>
+#include <Eigen/Core>
 #include <Eigen/SparseCholesky>
 #include <Euclid/Util/Memory.h>
 
@@ -10,7 +13,26 @@ namespace Euclid
 {
 /**@{ @ingroup PkgDistance*/
 
-/** Single source approximate geodesic distance using the heat method.
+/** Approximate geodesic distance using the heat method.
+ *
+ *  Distances are computed from a single source, from the nearest of a set of
+ *  sources, or from each of many sources in batches. A batch solves both
+ *  linear systems with one right-hand side per source, so the factors are
+ *  traversed once per batch rather than once per source.
+ *
+ *  The gradient and divergence operators are assembled as sparse matrices
+ *  when building, so a query only consists of the two solves, two sparse
+ *  products and the normalization of the gradients, the latter three being
+ *  parallel if OpenMP is enabled.
+ *
+ *  The heat factorizations of the recently used time scales are cached, so
+ *  sweeping back and forth over a few scales only factors each of them once.
+ *
+ *  The queries are const and only read the factors, so several threads may
+ *  query one instance at the same time, each with its own Workspace. Within
+ *  an OpenMP parallel region the parallel loops of a query run serially as
+ *  nested parallelism is disabled by default. build, scale and cache_size
+ *  must not run concurrently with the queries.
  *
  *  **Reference**
  *
@@ -29,6 +51,23 @@ public:
     using FT = typename Kernel::FT;
     using Vector_3 = typename Kernel::Vector_3;
     using SpMat = Eigen::SparseMatrix<FT>;
+    using RowSpMat = Eigen::SparseMatrix<FT, Eigen::RowMajor>;
+    using Vertex = typename boost::graph_traits<const Mesh>::vertex_descriptor;
+    using Mat = Eigen::Matrix<FT, Eigen::Dynamic, Eigen::Dynamic>;
+
+    /** Scratch memory of the queries.
+     *
+     *  Passing the same workspace to consecutive queries avoids reallocating
+     *  its dense matrices. A workspace must not be shared among threads.
+     */
+    struct Workspace
+    {
+        Mat delta;
+        Mat heat;
+        Mat gradients;
+        Mat divergences;
+        Mat geodesics;
+    };
 
 public:
     /** Build up the necesssary computational components.
@@ -52,22 +91,79 @@ public:
                const SpMat* mass_mat = nullptr);
 
     /** Reset the time scale.
+     *
+     *  The poisson factorization doesn't depend on the scale and is kept. If
+     *  the scale is among the cached ones its heat factorization is reused
+     *  directly, otherwise the least recently used one is refactored. The
+     *  sparsity pattern is the same for all scales, so only a numeric
+     *  factorization happens once the cache is full.
      *
      *  @param scale The time scale of the heat diffusion, relative to the
      *  average edge length of the mesh.
      */
     void scale(float scale);
 
+    /** Set the number of cached heat factorizations.
+     *
+     *  Each one holds a sparse factor of the size of the poisson one. The
+     *  least recently used ones are dropped if the cache shrinks.
+     *
+     *  @param size Number of time scales to cache, at least 1, default to 4.
+     */
+    void cache_size(unsigned size);
+
+    /** The heat equation solver of the current time scale.
+     *
+     *  It's an entry of the factorization cache, owned by this object and
+     *  replaced by build() and scale().
+     */
+    const Eigen::SimplicialLDLT<SpMat>& heat_solver() const;
+
     /** Compute geodesics distance from a vertex.
      *
      *  @param v The vertex descriptor.
      *  @param geodesics The output geodesics distances from all the mesh
      *  vertices to the target vertex v.
+     *  @param workspace Scratch memory of the query, a temporary one is used
+     *  if it's nullptr.
      */
     template<typename T>
-    void compute(
-        const typename boost::graph_traits<const Mesh>::vertex_descriptor& v,
-        std::vector<T>& geodesics);
+    void compute(const Vertex& v,
+                 std::vector<T>& geodesics,
+                 Workspace* workspace = nullptr) const;
+
+    /** Compute geodesics distance from a set of vertices.
+     *
+     *  The heat diffuses from all the sources at once, so the distance of
+     *  each vertex is the one to its nearest source.
+     *
+     *  @param sources The source vertices.
+     *  @param geodesics The output geodesics distances from all the mesh
+     *  vertices to the nearest source.
+     *  @param workspace Scratch memory of the query, a temporary one is used
+     *  if it's nullptr.
+     */
+    template<typename T>
+    void compute(const std::vector<Vertex>& sources,
+                 std::vector<T>& geodesics,
+                 Workspace* workspace = nullptr) const;
+
+    /** Compute geodesics distance from each of several vertices.
+     *
+     *  @param sources The source vertices.
+     *  @param geodesics The output geodesics distances, one column per source
+     *  and one row per mesh vertex.
+     *  @param block_size Number of sources solved together, which bounds the
+     *  memory to a few dense matrices of that many columns, the largest one
+     *  having three rows per face.
+     *  @param workspace Scratch memory of the query, a temporary one is used
+     *  if it's nullptr.
+     */
+    template<typename Derived>
+    void compute_batch(const std::vector<Vertex>& sources,
+                       Eigen::ArrayBase<Derived>& geodesics,
+                       unsigned block_size = 32,
+                       Workspace* workspace = nullptr) const;
 
 public:
     /** The target mesh.
@@ -83,27 +179,52 @@ public:
 
     /** Cotangent matrix.
      *
-     *  If you directly set this member without calling the build, you need to
-     *  update heat_solver and poisson_solver manually.
+     *  Pass a precomputed matrix to build() rather than setting this member
+     *  directly, the heat factorizations and poisson_solver are only
+     *  computed by build(). Changing it afterwards leaves them stale.
      */
     ProPtr<const SpMat> cot_mat = nullptr;
 
     /** Mass matrix.
      *
-     *  If you directly set this member without calling the build, you need to
-     *  update heat_solver and poisson_solver manually.
+     *  Pass a precomputed matrix to build() rather than setting this member
+     *  directly, the heat factorizations are only computed by build() and
+     *  scale(). Changing it afterwards leaves the cached ones stale.
      */
     ProPtr<const SpMat> mass_mat = nullptr;
 
-    /** The heat equation solver.
+    /** Gradient operator.
      *
+     *  Map a function on the vertices to its gradient on the faces, row
+     *  3f + d being the coordinate d of the gradient on face f.
      */
-    Eigen::SimplicialLDLT<SpMat> heat_solver;
+    RowSpMat gradient_mat;
+
+    /** Integrated divergence operator.
+     *
+     *  Map a vector field on the faces, laid out as in gradient_mat, to its
+     *  integrated divergence on the vertices.
+     */
+    RowSpMat divergence_mat;
 
     /** The poisson equation solver.
      *
      */
     Eigen::SimplicialLDLT<SpMat> poisson_solver;
+
+private:
+    void _factor_heat(float scale);
+
+    void _build_operators();
+
+    void _solve(Workspace& ws) const;
+
+private:
+    // Heat factorizations keyed by scale, the most recently used first. The
+    // solvers are neither copyable nor movable, and list nodes never move.
+    std::list<std::pair<float, Eigen::SimplicialLDLT<SpMat>>> _heat_factors;
+    unsigned _cache_size = 4;
+    const Eigen::SimplicialLDLT<SpMat>* _heat_solver = nullptr;
 };
 
 /** @}*/
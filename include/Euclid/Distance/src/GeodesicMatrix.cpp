@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <Eigen/Core>
+
+namespace Euclid
+{
+
+namespace _impl
+{
+
+// Edge length of the tiles averaged with their transposes, one of them is
+// held per thread
+constexpr size_t geodesic_tile = 512;
+
+// Create the file with its final size, so that it can be mapped as a whole
+inline void create_geodesic_file(const std::string& filename, size_t bytes)
+{
+    std::ofstream stream(filename, std::ios::binary | std::ios::trunc);
+    if (stream && bytes > 0) {
+        stream.seekp(bytes - 1);
+        stream.put(0);
+    }
+    if (!stream) {
+        throw std::runtime_error("Unable to create " + filename + ".");
+    }
+}
+
+template<typename S, typename Mesh>
+void write_geodesic_rows(
+    const GeodesicsInHeat<Mesh>& heat_method,
+    const std::vector<typename GeodesicsInHeat<Mesh>::Vertex>& sources,
+    const std::string& filename,
+    unsigned block_size,
+    const std::function<void(size_t, size_t)>& progress,
+    bool symmetrize)
+{
+    if (heat_method.mesh == nullptr) {
+        throw std::invalid_argument("The heat method must be built first.");
+    }
+    if (block_size == 0) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+    const size_t nv = num_vertices(*heat_method.mesh);
+    const size_t ns = sources.size();
+    create_geodesic_file(filename, ns * nv * sizeof(S));
+    if (ns == 0 || nv == 0) { return; }
+
+    // The threads write their rows straight into the mapped file, the pages
+    // are flushed by the system as it sees fit
+    boost::interprocess::file_mapping file(filename.c_str(),
+                                           boost::interprocess::read_write);
+    boost::interprocess::mapped_region region(file,
+                                              boost::interprocess::read_write);
+    const auto data = static_cast<S*>(region.get_address());
+    Eigen::Map<Eigen::Array<S, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>
+        matrix(data, ns, nv);
+
+    // Solve the blocks of sources concurrently, each thread with its own
+    // workspace, the parallel loops of the heat method then run serially
+    const auto nblocks =
+        static_cast<std::ptrdiff_t>((ns + block_size - 1) / block_size);
+    size_t done = 0;
+
+    // An exception mustn't escape the parallel region, so the first one is
+    // kept and rethrown afterwards, and the remaining work is skipped
+    std::exception_ptr error;
+    bool aborted = false;
+    auto fail = [&](std::exception_ptr e) {
+#pragma omp critical(euclid_geodesic_matrix)
+        {
+            if (!error) { error = e; }
+        }
+#pragma omp atomic write
+        aborted = true;
+    };
+    auto skip = [&]() {
+        bool result;
+#pragma omp atomic read
+        result = aborted;
+        return result;
+    };
+
+#pragma omp parallel
+    {
+        typename GeodesicsInHeat<Mesh>::Workspace workspace;
+        std::vector<typename GeodesicsInHeat<Mesh>::Vertex> block;
+        Eigen::Array<S, Eigen::Dynamic, Eigen::Dynamic> rows;
+
+#pragma omp for schedule(dynamic)
+        for (std::ptrdiff_t b = 0; b < nblocks; ++b) {
+            if (skip()) { continue; }
+            const size_t first = b * block_size;
+            const auto count = std::min<size_t>(block_size, ns - first);
+            try {
+                block.assign(sources.begin() + first,
+                             sources.begin() + first + count);
+                heat_method.compute_batch(block, rows, block_size, &workspace);
+            }
+            catch (...) {
+                fail(std::current_exception());
+                continue;
+            }
+
+            // A column of distances per source is a row of the file
+            std::memcpy(
+                data + first * nv, rows.data(), rows.size() * sizeof(S));
+            std::exception_ptr failure;
+#pragma omp critical(euclid_geodesic_matrix)
+            {
+                done += count;
+                try {
+                    if (progress && !error) { progress(done, ns); }
+                }
+                catch (...) {
+                    failure = std::current_exception();
+                }
+            }
+            if (failure) { fail(failure); }
+        }
+
+        // Average the pairs of transposed tiles, once all rows are written
+        if (symmetrize) {
+            const auto ntiles =
+                static_cast<std::ptrdiff_t>((nv + geodesic_tile - 1) /
+                                            geodesic_tile);
+            Eigen::Array<S, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+                tile;
+
+#pragma omp for schedule(dynamic)
+            for (std::ptrdiff_t t = 0; t < ntiles * ntiles; ++t) {
+                const size_t row = t / ntiles * geodesic_tile;
+                const size_t col = t % ntiles * geodesic_tile;
+                if (row > col || skip()) { continue; }
+                const auto rcount = std::min(geodesic_tile, nv - row);
+                const auto ccount = std::min(geodesic_tile, nv - col);
+                auto upper = matrix.block(row, col, rcount, ccount);
+                auto lower = matrix.block(col, row, ccount, rcount);
+                try {
+                    tile = ((upper.template cast<float>() +
+                             lower.transpose().template cast<float>()) *
+                            0.5f)
+                               .template cast<S>();
+                }
+                catch (...) {
+                    fail(std::current_exception());
+                    continue;
+                }
+                upper = tile;
+                lower = tile.transpose();
+            }
+        }
+    }
+    if (error) { std::rethrow_exception(error); }
+    if (!region.flush()) {
+        throw std::runtime_error("Unable to write " + filename + ".");
+    }
+}
+
+template<typename Mesh>
+void write_geodesic_matrix(
+    const GeodesicsInHeat<Mesh>& heat_method,
+    const std::vector<typename GeodesicsInHeat<Mesh>::Vertex>& sources,
+    const std::string& filename,
+    GeodesicPrecision precision,
+    unsigned block_size,
+    const std::function<void(size_t, size_t)>& progress,
+    bool symmetrize)
+{
+    if (precision == GeodesicPrecision::float16) {
+        write_geodesic_rows<Eigen::half>(
+            heat_method, sources, filename, block_size, progress, symmetrize);
+    }
+    else {
+        write_geodesic_rows<float>(
+            heat_method, sources, filename, block_size, progress, symmetrize);
+    }
+}
+
+} // namespace _impl
+
+template<typename Mesh>
+void geodesic_matrix(const GeodesicsInHeat<Mesh>& heat_method,
+                     const std::string& filename,
+                     GeodesicPrecision precision,
+                     unsigned block_size,
+                     const std::function<void(size_t, size_t)>& progress)
+{
+    if (heat_method.mesh == nullptr) {
+        throw std::invalid_argument("The heat method must be built first.");
+    }
+    const auto& mesh = *heat_method.mesh;
+    auto vimap = get(boost::vertex_index, mesh);
+    std::vector<typename GeodesicsInHeat<Mesh>::Vertex> sources(
+        num_vertices(mesh));
+    for (const auto& v : vertices(mesh)) {
+        sources[get(vimap, v)] = v;
+    }
+    _impl::write_geodesic_matrix(heat_method,
+                                 sources,
+                                 filename,
+                                 precision,
+                                 block_size,
+                                 progress,
+                                 true);
+}
+
+template<typename Mesh>
+void geodesic_matrix(
+    const GeodesicsInHeat<Mesh>& heat_method,
+    const std::vector<typename GeodesicsInHeat<Mesh>::Vertex>& landmarks,
+    const std::string& filename,
+    GeodesicPrecision precision,
+    unsigned block_size,
+    const std::function<void(size_t, size_t)>& progress)
+{
+    _impl::write_geodesic_matrix(heat_method,
+                                 landmarks,
+                                 filename,
+                                 precision,
+                                 block_size,
+                                 progress,
+                                 false);
+}
+
+} // namespace Euclid
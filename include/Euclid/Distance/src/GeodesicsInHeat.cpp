@@ -1,4 +1,12 @@
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+
 #include <Eigen/Core>
+#include <Eigen/SparseCore>
 #include <Euclid/Geometry/TriMeshGeometry.h>
 #include <Euclid/Math/Vector.h>
 #include <Euclid/Util/Assert.h>
@@ -26,8 +34,6 @@ void GeodesicsInHeat<Mesh>::build(const Mesh& mesh,
     }
 
     // Construct the equations
-    FT diffuse_time =
-        this->resolution * this->resolution * static_cast<FT>(scale);
     if (cot_mat) { this->cot_mat.reset(cot_mat); }
     else {
         this->cot_mat.reset(new SpMat(cotangent_matrix(mesh)), true);
@@ -36,64 +42,200 @@ void GeodesicsInHeat<Mesh>::build(const Mesh& mesh,
     else {
         this->mass_mat.reset(new SpMat(mass_matrix(mesh)), true);
     }
-    SpMat heat_mat = *this->mass_mat + diffuse_time * *this->cot_mat;
 
-    // Factorize the heat matrix
-    this->heat_solver.compute(heat_mat);
-    if (this->heat_solver.info() != Eigen::Success) {
-        throw std::runtime_error("Unable to factor the heat equation.");
-    }
+    // Factorize the heat matrix, the cached ones belong to the previous mesh
+    _heat_solver = nullptr;
+    _heat_factors.clear();
+    _factor_heat(scale);
 
     // Factorize the laplacian matrix
     this->poisson_solver.compute(-*this->cot_mat);
     if (this->poisson_solver.info() != Eigen::Success) {
         throw std::runtime_error("Unable to factor the poisson equation.");
     }
+
+    // The gradient and divergence operators only depend on the geometry
+    _build_operators();
 }
 
 template<typename Mesh>
 void GeodesicsInHeat<Mesh>::scale(float scale)
 {
-    FT diffuse_time = this->resolution * this->resolution * scale;
-    SpMat heat_mat = *this->mass_mat + diffuse_time * *this->cot_mat;
+    // The poisson equation doesn't depend on the scale
+    _factor_heat(scale);
+}
 
-    // Factorize the heat matrix
-    this->heat_solver.compute(heat_mat);
-    if (this->heat_solver.info() != Eigen::Success) {
-        throw std::runtime_error("Unable to factor the heat equation.");
+template<typename Mesh>
+void GeodesicsInHeat<Mesh>::cache_size(unsigned size)
+{
+    if (size == 0) {
+        throw std::invalid_argument("At least one factorization is cached.");
     }
+    _cache_size = size;
+    // The current factorization is the front one and is never dropped
+    while (_heat_factors.size() > _cache_size) {
+        _heat_factors.pop_back();
+    }
+}
 
-    // Factorize the laplacian matrix
-    this->poisson_solver.compute(-*this->cot_mat);
-    if (this->poisson_solver.info() != Eigen::Success) {
-        throw std::runtime_error("Unable to factor the poisson equation.");
+template<typename Mesh>
+const Eigen::SimplicialLDLT<typename GeodesicsInHeat<Mesh>::SpMat>&
+GeodesicsInHeat<Mesh>::heat_solver() const
+{
+    if (_heat_solver == nullptr) {
+        throw std::runtime_error("The heat method must be built first.");
     }
+    return *_heat_solver;
 }
 
 template<typename Mesh>
 template<typename T>
-void GeodesicsInHeat<Mesh>::compute(
-    const typename boost::graph_traits<const Mesh>::vertex_descriptor& v,
-    std::vector<T>& geodesics)
+void GeodesicsInHeat<Mesh>::compute(const Vertex& v,
+                                    std::vector<T>& geodesics,
+                                    Workspace* workspace) const
 {
-    auto vpmap = get(boost::vertex_point, *this->mesh);
+    Workspace temporary;
+    auto& ws = workspace ? *workspace : temporary;
     auto vimap = get(boost::vertex_index, *this->mesh);
-    auto fimap = get(boost::face_index, *this->mesh);
-    const auto zero = static_cast<FT>(0.0);
-    const auto half = static_cast<FT>(0.5);
-    using Mat = Eigen::Matrix<FT, Eigen::Dynamic, 1>;
+    const auto nv = num_vertices(*this->mesh);
+    ws.delta.setZero(nv, 1);
+    ws.delta(get(vimap, v), 0) = 1.0f;
+    _solve(ws);
+    const auto& geod = ws.geodesics;
 
-    // Solve the heat equation
-    Mat delta = Mat::Zero(num_vertices(*this->mesh));
-    delta(get(vimap, v), 0) = 1.0f;
-    Mat heat = this->heat_solver.solve(delta);
-    if (this->heat_solver.info() != Eigen::Success) {
-        throw std::runtime_error("Unable to solve the heat equation.");
+    geodesics.resize(nv);
+    for (size_t i = 0; i < nv; ++i) {
+        geodesics[i] = static_cast<T>(geod(i, 0) - geod(get(vimap, v), 0));
+        EASSERT(geodesics[i] >= 0.0);
     }
+}
 
-    // Evaluate the normalized gradient field of the diffusion
-    size_t fidx = 0;
-    std::vector<Vector_3> gradients(num_faces(*this->mesh));
+template<typename Mesh>
+template<typename T>
+void GeodesicsInHeat<Mesh>::compute(const std::vector<Vertex>& sources,
+                                    std::vector<T>& geodesics,
+                                    Workspace* workspace) const
+{
+    if (sources.empty()) {
+        throw std::invalid_argument("At least one source is needed.");
+    }
+    Workspace temporary;
+    auto& ws = workspace ? *workspace : temporary;
+    auto vimap = get(boost::vertex_index, *this->mesh);
+    const auto nv = num_vertices(*this->mesh);
+    ws.delta.setZero(nv, 1);
+    for (const auto& v : sources) {
+        ws.delta(get(vimap, v), 0) = 1.0f;
+    }
+    _solve(ws);
+    const auto& geod = ws.geodesics;
+
+    // The distance is only determined up to a constant, the nearest source
+    // is set to zero
+    auto offset = geod(get(vimap, sources[0]), 0);
+    for (const auto& v : sources) {
+        offset = std::min(offset, geod(get(vimap, v), 0));
+    }
+    geodesics.resize(nv);
+    for (size_t i = 0; i < nv; ++i) {
+        geodesics[i] = static_cast<T>(geod(i, 0) - offset);
+    }
+}
+
+template<typename Mesh>
+template<typename Derived>
+void GeodesicsInHeat<Mesh>::compute_batch(const std::vector<Vertex>& sources,
+                                          Eigen::ArrayBase<Derived>& geodesics,
+                                          unsigned block_size,
+                                          Workspace* workspace) const
+{
+    if (block_size == 0) {
+        throw std::invalid_argument("Block size must be positive.");
+    }
+    Workspace temporary;
+    auto& ws = workspace ? *workspace : temporary;
+    auto vimap = get(boost::vertex_index, *this->mesh);
+    const auto nv = num_vertices(*this->mesh);
+    geodesics.derived().resize(nv, sources.size());
+
+    for (size_t first = 0; first < sources.size(); first += block_size) {
+        auto count = std::min<size_t>(block_size, sources.size() - first);
+        ws.delta.setZero(nv, count);
+        for (size_t j = 0; j < count; ++j) {
+            ws.delta(get(vimap, sources[first + j]), j) = 1.0f;
+        }
+        _solve(ws);
+        const auto& geod = ws.geodesics;
+        for (size_t j = 0; j < count; ++j) {
+            auto source = get(vimap, sources[first + j]);
+            geodesics.derived().col(first + j) =
+                (geod.col(j).array() - geod(source, j))
+                    .template cast<typename Derived::Scalar>();
+        }
+    }
+}
+
+template<typename Mesh>
+void GeodesicsInHeat<Mesh>::_factor_heat(float scale)
+{
+    auto cached = std::find_if(
+        _heat_factors.begin(), _heat_factors.end(), [scale](const auto& f) {
+            return f.first == scale;
+        });
+    if (cached != _heat_factors.end()) {
+        _heat_factors.splice(_heat_factors.begin(), _heat_factors, cached);
+        _heat_solver = &_heat_factors.front().second;
+        return;
+    }
+
+    FT diffuse_time =
+        this->resolution * this->resolution * static_cast<FT>(scale);
+    SpMat heat_mat = *this->mass_mat + diffuse_time * *this->cot_mat;
+    if (_heat_factors.size() < _cache_size) {
+        // A new solver analyzes the sparsity pattern once
+        _heat_factors.emplace_front(std::piecewise_construct,
+                                    std::forward_as_tuple(scale),
+                                    std::forward_as_tuple());
+        _heat_factors.front().second.analyzePattern(heat_mat);
+    }
+    else {
+        // Recycle the least recently used solver, whose symbolic analysis
+        // still holds as the pattern doesn't depend on the scale
+        _heat_factors.splice(_heat_factors.begin(),
+                             _heat_factors,
+                             std::prev(_heat_factors.end()));
+        _heat_factors.front().first = scale;
+    }
+
+    // Factorize the heat matrix
+    auto& solver = _heat_factors.front().second;
+    _heat_solver = &solver;
+    solver.factorize(heat_mat);
+    if (solver.info() != Eigen::Success) {
+        // Never hit the failed factorization in the cache again
+        _heat_factors.front().first = std::numeric_limits<float>::quiet_NaN();
+        throw std::runtime_error("Unable to factor the heat equation.");
+    }
+}
+
+template<typename Mesh>
+void GeodesicsInHeat<Mesh>::_build_operators()
+{
+    using Triplet = Eigen::Triplet<FT>;
+    auto vpmap = get(boost::vertex_point, *this->mesh);
+    auto vimap = get(boost::vertex_index, *this->mesh);
+    const auto half = static_cast<FT>(0.5);
+    const auto nv = static_cast<int>(num_vertices(*this->mesh));
+    const auto nf = static_cast<int>(num_faces(*this->mesh));
+
+    // Row 3f + d of the gradient operator is the coordinate d of the gradient
+    // on face f, summing the gradients of the hat functions of the corners.
+    // The divergence operator maps the gradients to the integrated divergence
+    // of every vertex, through the cotangent weighted edges of its corners.
+    std::vector<Triplet> gradients, divergences;
+    gradients.reserve(9 * nf);
+    divergences.reserve(9 * nf);
+    int fidx = 0;
     for (const auto& f : faces(*this->mesh)) {
         auto fn = face_normal(f, *this->mesh);
         auto fa = face_area(f, *this->mesh);
@@ -101,45 +243,69 @@ void GeodesicsInHeat<Mesh>::compute(
         auto v0 = source(he, *this->mesh);
         auto v1 = target(he, *this->mesh);
         auto v2 = target(next(he, *this->mesh), *this->mesh);
-        auto e0 = get(vpmap, v2) - get(vpmap, v1);
-        auto e1 = get(vpmap, v0) - get(vpmap, v2);
-        auto e2 = get(vpmap, v1) - get(vpmap, v0);
-        auto g = half / fa *
-                 (heat[get(vimap, v0)] * CGAL::cross_product(fn, e0) +
-                  heat[get(vimap, v1)] * CGAL::cross_product(fn, e1) +
-                  heat[get(vimap, v2)] * CGAL::cross_product(fn, e2));
-        gradients[fidx++] = -normalized(g);
+        std::array<typename Kernel::Point_3, 3> p{
+            get(vpmap, v0), get(vpmap, v1), get(vpmap, v2)};
+        std::array<int, 3> c{static_cast<int>(get(vimap, v0)),
+                             static_cast<int>(get(vimap, v1)),
+                             static_cast<int>(get(vimap, v2))};
+        for (int k = 0; k < 3; ++k) {
+            const auto& pk = p[k];
+            const auto& pi = p[(k + 2) % 3];
+            const auto& pj = p[(k + 1) % 3];
+            auto grad = half / fa * CGAL::cross_product(fn, pi - pj);
+            auto weight = half * (cotangent(pk, pi, pj) * (pj - pk) +
+                                  cotangent(pk, pj, pi) * (pi - pk));
+            for (int d = 0; d < 3; ++d) {
+                gradients.emplace_back(3 * fidx + d, c[k], grad[d]);
+                divergences.emplace_back(c[k], 3 * fidx + d, weight[d]);
+            }
+        }
+        ++fidx;
     }
+    this->gradient_mat.resize(3 * nf, nv);
+    this->gradient_mat.setFromTriplets(gradients.begin(), gradients.end());
+    this->divergence_mat.resize(nv, 3 * nf);
+    this->divergence_mat.setFromTriplets(divergences.begin(),
+                                         divergences.end());
+}
 
-    // Compute the integrated divergence of gradients
-    Mat divs(num_vertices(*this->mesh));
-    for (const auto& v : vertices(*this->mesh)) {
-        FT divergence = zero;
-        auto p = get(vpmap, v);
-        for (const auto& he : halfedges_around_target(v, *this->mesh)) {
-            auto f = face(he, *this->mesh);
-            auto g = gradients[get(fimap, f)];
-            auto vi = source(he, *this->mesh);
-            auto vj = target(next(he, *this->mesh), *this->mesh);
-            auto pi = get(vpmap, vi);
-            auto pj = get(vpmap, vj);
-            divergence += cotangent(p, pi, pj) * ((pj - p) * g) +
-                          cotangent(p, pj, pi) * ((pi - p) * g);
+template<typename Mesh>
+void GeodesicsInHeat<Mesh>::_solve(Workspace& ws) const
+{
+    // The solvers and operators are only read, the intermediate results live
+    // in the workspace of the caller
+    // Solve the heat equation, one column per right-hand side
+    ws.heat = _heat_solver->solve(ws.delta);
+    if (_heat_solver->info() != Eigen::Success) {
+        throw std::runtime_error("Unable to solve the heat equation.");
+    }
+
+    // Evaluate the normalized gradient field of the diffusion, the products
+    // of the row-major operators run in parallel if OpenMP is enabled
+    ws.gradients.noalias() = this->gradient_mat * ws.heat;
+    auto& gradients = ws.gradients;
+    const auto nf = static_cast<int>(gradients.rows() / 3);
+    const auto eps = std::numeric_limits<FT>::epsilon() * 10;
+#pragma omp parallel for
+    for (int f = 0; f < nf; ++f) {
+        for (Eigen::Index j = 0; j < gradients.cols(); ++j) {
+            auto g = gradients.template block<3, 1>(3 * f, j);
+            auto length = g.norm();
+            if (length > eps) { g /= -length; }
+            else {
+                g = -g;
+            }
         }
-        divs(get(vimap, v), 0) = divergence * half;
     }
 
+    // Compute the integrated divergence of gradients
+    ws.divergences.noalias() = this->divergence_mat * gradients;
+
     // Solve the poisson equation
-    Mat geod = this->poisson_solver.solve(divs);
+    ws.geodesics = this->poisson_solver.solve(ws.divergences);
     if (this->poisson_solver.info() != Eigen::Success) {
         throw std::runtime_error("Unable to solve the poisson equation.");
     }
-
-    geodesics.resize(num_vertices(*this->mesh));
-    for (size_t i = 0; i < num_vertices(*this->mesh); ++i) {
-        geodesics[i] = static_cast<T>(geod(i, 0) - geod(get(vimap, v), 0));
-        EASSERT(geodesics[i] >= 0.0);
-    }
 }
 
 } // namespace Euclid
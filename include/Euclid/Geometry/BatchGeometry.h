@@ -0,0 +1,106 @@
+/** Geometry of many meshes at once.
+ *
+ *  This package computes a set of geometric quantities for a whole collection
+ *  of meshes. It's designed for pipelines processing a large number of small
+ *  meshes, where parallelizing inside each mesh doesn't pay off. Instead, the
+ *  meshes are dynamically scheduled among threads so that idle threads keep
+ *  picking up the remaining ones, and each thread reuses its scratch buffers
+ *  from one mesh to the next.
+ *
+ *  @defgroup PkgBatchGeometry BatchGeometry
+ *  @ingroup PkgGeometry
+ */
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+#include <CGAL/boost/graph/properties.h>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+
+namespace Euclid
+{
+/** @{*/
+
+/** Quantities to compute in batch_geometry().
+ *
+ */
+struct BatchQuantities
+{
+    /** Unit face normals. */
+    bool face_normals = false;
+    /** Face areas. */
+    bool face_areas = false;
+    /** Mean, Gaussian and principal curvatures. */
+    bool curvatures = false;
+    /** Principal directions, only used when curvatures is true. */
+    bool principal_directions = false;
+    /** Cotangent matrix. */
+    bool cotangent_matrix = false;
+    /** Mass matrix with mixed voronoi areas. */
+    bool mass_matrix = false;
+    /** Graph Laplacian, i.e. degree matrix minus adjacency matrix. */
+    bool graph_laplacian = false;
+};
+
+/** Geometric quantities of one mesh computed by batch_geometry().
+ *
+ *  Members that are not requested are left empty.
+ *
+ *  @sa BatchQuantities
+ */
+template<typename T>
+struct BatchGeometry
+{
+    /** Unit face normals, 3 values per face. */
+    std::vector<T> face_normals;
+    /** Face areas, 1 value per face. */
+    std::vector<T> face_areas;
+    /** Vertex curvatures.
+     *
+     *  @sa principal_curvatures
+     */
+    Curvatures<T> curvatures;
+    /** Cotangent matrix.
+     *
+     *  @sa cotangent_matrix
+     */
+    Eigen::SparseMatrix<T> cotangent_matrix;
+    /** Mass matrix.
+     *
+     *  @sa mass_matrix
+     */
+    Eigen::SparseMatrix<T> mass_matrix;
+    /** Graph Laplacian.
+     *
+     *  @sa adjacency_matrix
+     */
+    Eigen::SparseMatrix<T> graph_laplacian;
+};
+
+/** Compute geometric quantities of a collection of meshes.
+ *
+ *  @param first Iterator to the first mesh.
+ *  @param last Iterator past the last mesh.
+ *  @param quantities The quantities to compute.
+ *  @return Quantities of each mesh, in the same order as the input.
+ *
+ *  @tparam ForwardIt Forward iterator whose value type is a mesh.
+ *  @tparam T Optional, derived from the mesh type.
+ */
+template<typename ForwardIt,
+         typename T = typename CGAL::Kernel_traits<
+             typename boost::property_traits<typename boost::property_map<
+                 typename std::iterator_traits<ForwardIt>::value_type,
+                 boost::vertex_point_t>::type>::value_type>::Kernel::FT>
+std::vector<BatchGeometry<T>> batch_geometry(
+    ForwardIt first,
+    ForwardIt last,
+    const BatchQuantities& quantities);
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/BatchGeometry.cpp"
@@ -0,0 +1,193 @@
+/** Matrix-free cotangent Laplacian.
+ *
+ *  This package provides the cotangent Laplacian as a linear operator which
+ *  is applied on the fly from the raw position and index buffers, so no
+ *  nonzero of the matrix is ever stored. Every product recomputes the
+ *  cotangent weights with the SIMD block kernels of TriMeshKernels and
+ *  scatters the face contributions directly, so besides the caller's buffers
+ *  the operator only keeps one index per block of faces.
+ *
+ *  The blocks are colored such that no two blocks of the same color share a
+ *  vertex, then the blocks of a color scatter without conflicts and run in
+ *  parallel if OpenMP is enabled, which also parallelizes the product with a
+ *  single vector, e.g. within Eigen::ConjugateGradient.
+ *
+ *  The operator could be used with Eigen's iterative solvers, e.g.
+ *  Eigen::ConjugateGradient with Eigen::IdentityPreconditioner, and with
+ *  Spectra's solvers through the perform_op() interface.
+ *
+ *  @defgroup PkgMatrixFreeLaplacian MatrixFreeLaplacian
+ *  @ingroup PkgGeometry
+ */
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+namespace Euclid
+{
+template<typename FT, typename IT>
+class MatrixFreeLaplacian;
+} // namespace Euclid
+
+namespace Eigen
+{
+namespace internal
+{
+
+template<typename FT, typename IT>
+struct traits<Euclid::MatrixFreeLaplacian<FT, IT>>
+    : public traits<Eigen::SparseMatrix<FT>>
+{};
+
+} // namespace internal
+} // namespace Eigen
+
+namespace Euclid
+{
+/** @{*/
+
+/** A matrix-free cotangent Laplacian.
+ *
+ *  Represent the operator @f$D+L@f$, where @f$L@f$ is the cotangent Laplacian
+ *  with the same sign convention as cotangent_matrix(), and @f$D@f$ is an
+ *  optional diagonal term, e.g. @f$M/t@f$ when solving the heat equation.
+ *
+ *  @tparam FT Scalar type.
+ *  @tparam IT Index type.
+ *
+ *  @sa cotangent_matrix
+ */
+template<typename FT, typename IT = int>
+class MatrixFreeLaplacian
+    : public Eigen::EigenBase<MatrixFreeLaplacian<FT, IT>>
+{
+public:
+    using Scalar = FT;
+    using RealScalar = FT;
+    using StorageIndex = int;
+    using Index = Eigen::Index;
+    using Vec = Eigen::Matrix<FT, Eigen::Dynamic, 1>;
+    using Mat = Eigen::Matrix<FT, Eigen::Dynamic, Eigen::Dynamic>;
+
+    enum
+    {
+        ColsAtCompileTime = Eigen::Dynamic,
+        MaxColsAtCompileTime = Eigen::Dynamic,
+        IsRowMajor = false
+    };
+
+public:
+    /** Build the operator.
+     *
+     *  The buffers are referenced rather than copied, so they must be kept
+     *  alive and unchanged while the operator is in use.
+     *
+     *  @param positions Vertex positions, 3 values per vertex.
+     *  @param indices Triangle indices, 3 values per face.
+     */
+    void build(const std::vector<FT>& positions,
+               const std::vector<IT>& indices);
+
+    /** Temporary buffers would dangle. */
+    void build(std::vector<FT>&&, const std::vector<IT>&) = delete;
+    void build(const std::vector<FT>&, std::vector<IT>&&) = delete;
+    void build(std::vector<FT>&&, std::vector<IT>&&) = delete;
+
+    /** Set the diagonal term.
+     *
+     *  @param diagonal The diagonal entries, pass an empty vector to remove
+     *  the term.
+     */
+    void set_diagonal(const Vec& diagonal);
+
+    /** Number of rows. */
+    Index rows() const;
+
+    /** Number of columns. */
+    Index cols() const;
+
+    /** Diagonal entries of the operator, e.g. for preconditioning. */
+    Vec diagonal() const;
+
+    /** Accumulate the product of the operator.
+     *
+     *  Compute @f$y\leftarrow y+\alpha(D+L)x@f$, column by column.
+     *
+     *  @param x Input vectors.
+     *  @param y Output vectors.
+     *  @param alpha Scaling factor.
+     */
+    template<typename DerivedY>
+    void apply(const Eigen::Ref<const Mat>& x,
+               Eigen::MatrixBase<DerivedY>& y,
+               FT alpha = 1) const;
+
+    /** Product with a dense vector or matrix.
+     *
+     */
+    template<typename Rhs>
+    Eigen::Product<MatrixFreeLaplacian, Rhs, Eigen::AliasFreeProduct>
+    operator*(const Eigen::MatrixBase<Rhs>& x) const
+    {
+        return Eigen::Product<MatrixFreeLaplacian,
+                              Rhs,
+                              Eigen::AliasFreeProduct>(*this, x.derived());
+    }
+
+    /** Spectra matrix operation interface, y = (D + L)x.
+     *
+     */
+    void perform_op(const FT* x_in, FT* y_out) const;
+
+private:
+    // Call fn(first, n, cot) on the blocks of faces, where cot[c] holds the
+    // cotangents at corner c
+    template<typename Fn>
+    void _for_each_block(Fn fn) const;
+
+private:
+    const std::vector<FT>* _positions = nullptr;
+    const std::vector<IT>* _indices = nullptr;
+    Index _nv = 0;
+    std::vector<size_t> _blocks; // grouped by color
+    std::vector<size_t> _color_offsets;
+    Vec _diagonal;
+};
+
+/** @}*/
+} // namespace Euclid
+
+namespace Eigen
+{
+namespace internal
+{
+
+template<typename FT, typename IT, typename Rhs, int ProductType>
+struct generic_product_impl<Euclid::MatrixFreeLaplacian<FT, IT>,
+                            Rhs,
+                            SparseShape,
+                            DenseShape,
+                            ProductType>
+    : generic_product_impl_base<
+          Euclid::MatrixFreeLaplacian<FT, IT>,
+          Rhs,
+          generic_product_impl<Euclid::MatrixFreeLaplacian<FT, IT>, Rhs>>
+{
+    template<typename Dest>
+    static void scaleAndAddTo(Dest& dst,
+                              const Euclid::MatrixFreeLaplacian<FT, IT>& lhs,
+                              const Rhs& rhs,
+                              const FT& alpha)
+    {
+        lhs.apply(rhs, dst, alpha);
+    }
+};
+
+} // namespace internal
+} // namespace Eigen
+
+#include "src/MatrixFreeLaplacian.cpp"
@@ -0,0 +1,142 @@
+/** Mesh operators sharing one sparsity pattern.
+ *
+ *  Most of the sparse operators on a triangle mesh, e.g. the graph Laplacian,
+ *  the cotangent Laplacian and the mass matrix, are supported on the same set
+ *  of entries, namely the one-ring neighborhood of each vertex plus the
+ *  diagonal. This package builds that pattern once per mesh and stores every
+ *  operator as a plain value array over it. Combining operators, e.g. forming
+ *  the heat operator @f$M+tL@f$, is then an elementwise vector operation that
+ *  involves no symbolic work, and the index arrays are shared among all the
+ *  operators.
+ *
+ *  @defgroup PkgOperatorRegistry OperatorRegistry
+ *  @ingroup PkgGeometry
+ */
+#pragma once
+
+#include <vector>
+
+#include <CGAL/boost/graph/properties.h>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+
+namespace Euclid
+{
+/** @{*/
+
+/** A registry of mesh operators over a shared sparsity pattern.
+ *
+ *  The pattern is stored in compressed column form and is symmetric, so it
+ *  could equally be read as compressed rows. Each operator is a value array
+ *  with one entry per nonzero of the pattern, which could be viewed as an
+ *  Eigen sparse matrix without copying.
+ *
+ *  @tparam Mesh Mesh type.
+ */
+template<typename Mesh>
+class OperatorRegistry
+{
+public:
+    using VPMap =
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type;
+    using Point_3 = typename boost::property_traits<VPMap>::value_type;
+    using Kernel = typename CGAL::Kernel_traits<Point_3>::Kernel;
+    using FT = typename Kernel::FT;
+    using Vec = Eigen::Matrix<FT, Eigen::Dynamic, 1>;
+    using SpMat = Eigen::SparseMatrix<FT>;
+    using StorageIndex = typename SpMat::StorageIndex;
+
+public:
+    /** Build the sparsity pattern and all the operators of a mesh.
+     *
+     *  @param mesh The target mesh.
+     *  @param method The vertex area used for the mass matrix.
+     */
+    void build(const Mesh& mesh,
+               const VertexArea& method = VertexArea::mixed_voronoi);
+
+    /** Number of rows, i.e. the number of vertices. */
+    int size() const;
+
+    /** Number of nonzeros in the shared pattern. */
+    int nonzeros() const;
+
+    /** Position of entry (i, j) in the value arrays.
+     *
+     *  @return The position, or -1 if the entry is not in the pattern.
+     */
+    int index(int i, int j) const;
+
+    /** Values of the graph Laplacian.
+     *
+     *  @sa adjacency_matrix
+     */
+    const Vec& graph_laplacian() const;
+
+    /** Values of the degree matrix.
+     *
+     *  @sa adjacency_matrix
+     */
+    const Vec& degree() const;
+
+    /** Values of the cotangent Laplacian.
+     *
+     *  @sa cotangent_matrix
+     */
+    const Vec& cotangent_laplacian() const;
+
+    /** Values of the mass matrix.
+     *
+     *  @sa mass_matrix
+     */
+    const Vec& mass() const;
+
+    /** Values of the heat operator @f$M+tL@f$.
+     *
+     *  @param t Time step.
+     */
+    Vec heat(FT t) const;
+
+    /** Diagonal entries of an operator.
+     *
+     *  @param values Operator values over the pattern.
+     */
+    Vec diagonal(const Vec& values) const;
+
+    /** Values of @f$DXD@f$ for a diagonal matrix @f$D@f$.
+     *
+     *  @param values Operator values of @f$X@f$ over the pattern.
+     *  @param d Diagonal entries of @f$D@f$.
+     */
+    Vec scale(const Vec& values, const Vec& d) const;
+
+    /** View an operator as a sparse matrix without copying.
+     *
+     *  The view is valid as long as both the registry and the values are.
+     *
+     *  @param values Operator values over the pattern.
+     */
+    Eigen::Map<const SpMat> view(const Vec& values) const;
+
+    /** Copy an operator into a sparse matrix.
+     *
+     *  @param values Operator values over the pattern.
+     */
+    SpMat matrix(const Vec& values) const;
+
+private:
+    std::vector<StorageIndex> _outer;
+    std::vector<StorageIndex> _inner;
+    std::vector<StorageIndex> _cols; // column of each nonzero
+    std::vector<int> _diag;          // position of each diagonal entry
+    Vec _graph_laplacian;
+    Vec _degree;
+    Vec _cotangent_laplacian;
+    Vec _mass;
+};
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/OperatorRegistry.cpp"
@@ -0,0 +1,123 @@
+/** Parallel matrix operations for Spectra.
+ *
+ *  Spectra's eigen solvers access the matrix only through a small operation
+ *  class, e.g. the matrix-vector product or the shift-and-invert solve, and
+ *  the built-in ones are single-threaded. This package provides drop-in
+ *  replacements for symmetric sparse matrices that make use of multiple cores.
+ *
+ *  - ParallelSymMatProd partitions the rows among threads if OpenMP is
+ *  enabled.
+ *  - ParallelSymShiftSolve factorizes the shifted matrix with the parallel
+ *  supernodal Pardiso solver if Eigen is configured to use Intel MKL, i.e.
+ *  EIGEN_USE_MKL_ALL is defined, and falls back to a sequential sparse
+ *  @f$LDL^T@f$ factorization otherwise.
+ *
+ *  @defgroup PkgParallelMatOp ParallelMatOp
+ *  @ingroup PkgGeometry
+ */
+#pragma once
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#ifdef EIGEN_USE_MKL_ALL
+#include <Eigen/PardisoSupport>
+#else
+#include <Eigen/SparseCholesky>
+#endif
+
+namespace Euclid
+{
+/** @{*/
+
+/** Parallel product of a symmetric sparse matrix and a vector.
+ *
+ *  Implement the interface of Spectra::SparseSymMatProd.
+ *
+ *  @tparam T Scalar type.
+ */
+template<typename T>
+class ParallelSymMatProd
+{
+public:
+    using Scalar = T;
+    using SpMat = Eigen::SparseMatrix<T>;
+
+public:
+    /** Constructor.
+     *
+     *  @param mat A symmetric sparse matrix with both triangular parts
+     *  stored, it must be kept alive while the operation is in use.
+     */
+    explicit ParallelSymMatProd(const SpMat& mat);
+
+    /** Number of rows. */
+    int rows() const;
+
+    /** Number of columns. */
+    int cols() const;
+
+    /** Compute y = Ax.
+     *
+     */
+    void perform_op(const T* x_in, T* y_out) const;
+
+private:
+    const SpMat& _mat;
+};
+
+/** Parallel shift-and-invert solve of a symmetric sparse matrix.
+ *
+ *  Implement the interface of Spectra::SparseSymShiftSolve.
+ *
+ *  Only parallel with Intel MKL, i.e. if EIGEN_USE_MKL_ALL is defined, in
+ *  which case the factorization is Eigen::PardisoLDLT. Otherwise it is a
+ *  sequential Eigen::SimplicialLDLT, and both the factorization and the
+ *  solves in each Lanczos iteration run on a single thread.
+ *
+ *  @tparam T Scalar type.
+ */
+template<typename T>
+class ParallelSymShiftSolve
+{
+public:
+    using Scalar = T;
+    using SpMat = Eigen::SparseMatrix<T>;
+#ifdef EIGEN_USE_MKL_ALL
+    using Solver = Eigen::PardisoLDLT<SpMat>;
+#else
+    using Solver = Eigen::SimplicialLDLT<SpMat>;
+#endif
+
+public:
+    /** Constructor.
+     *
+     *  @param mat A symmetric sparse matrix, it must be kept alive while the
+     *  operation is in use.
+     */
+    explicit ParallelSymShiftSolve(const SpMat& mat);
+
+    /** Number of rows. */
+    int rows() const;
+
+    /** Number of columns. */
+    int cols() const;
+
+    /** Set the shift and factorize the shifted matrix.
+     *
+     */
+    void set_shift(T sigma);
+
+    /** Compute y = (A - sigma * I)^{-1}x.
+     *
+     */
+    void perform_op(const T* x_in, T* y_out) const;
+
+private:
+    const SpMat& _mat;
+    Solver _solver;
+};
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/ParallelMatOp.cpp"
@@ -15,6 +15,15 @@
  *  Spectral Geometry Processing with Manifold Harmonics.
  *  Computer Graphics Forum, 2008.
  *
+ *  [3] Knyazev, A. V.
+ *  Toward the Optimal Preconditioned Eigensolver: Locally Optimal Block
+ *  Preconditioned Conjugate Gradient Method.
+ *  SIAM Journal on Scientific Computing, 2001.
+ *
+ *  [4] Duersch, J. A., Shao, M., Yang, C., Gu, M.
+ *  A Robust and Efficient Implementation of LOBPCG.
+ *  SIAM Journal on Scientific Computing, 2018.
+ *
  *  @defgroup PkgSpectral Spectral
  *  @ingroup PkgGeometry
  */
@@ -59,7 +68,26 @@ enum class SpecDecomp
      *  Let @f$L=D^{-1}S@f$, then solving the generalized eigenvalue problem
      *  @f$SX=\lambda DX@f$.
      */
-    generalized
+    generalized,
+
+    /** Solving the symmetric Laplacian matrix with a block eigen solver.
+     *
+     *  The same eigenvalue problem as symmetric, solved by the locally optimal
+     *  block preconditioned conjugate gradient method [3, 4]. It iterates on a
+     *  block of vectors at once, so that most of the work is dense
+     *  matrix-matrix products, and it could start from approximate
+     *  eigenfunctions, see the spectrum() overload taking initial values.
+     */
+    lobpcg,
+
+    /** Approximating the symmetric Laplacian matrix on a coarser mesh.
+     *
+     *  Solve the eigenvalue problem on an aggregated coarse level, then
+     *  prolong and refine the eigenfunctions level by level, trading accuracy
+     *  for speed on large meshes. See multilevel_spectrum() for the settings
+     *  and the error estimates. All the requested eigenvalues are returned.
+     */
+    multilevel
 };
 
 /** Spectral decomposition of a mesh.
@@ -89,6 +117,79 @@ unsigned spectrum(const Mesh& mesh,
                   unsigned max_iter = 1000,
                   double tolerance = 1e-10);
 
+/** Spectral decomposition of a mesh from initial eigenfunctions.
+ *
+ *  Solve with SpecDecomp::lobpcg starting from approximate eigenfunctions,
+ *  e.g. the spectrum of the previous frame of a deforming mesh, or the
+ *  spectrum of a coarser mesh prolonged to this one. The closer they are to
+ *  the solution, the fewer iterations it takes to converge.
+ *
+ *  @param mesh The input mesh.
+ *  @param k The number of eigenvalues to compute. Note that the actual size of
+ *  the spectrum might be smaller than k when the computation doesn't converge.
+ *  @param lambdas The output eigenvalues, sorted in ascending order.
+ *  @param phis The output eigenfunctions corresponding to the eigenvalues.
+ *  @param initial The initial eigenfunctions, one per column and one row per
+ *  vertex. Missing columns are filled randomly and extra ones are ignored.
+ *  @param op The Laplace operator to use.
+ *  @param max_iter The maximum number of iterations for eigen decomposition.
+ *  @param tolerance The tolerance of accuracy loss in eigen decomposition.
+ *
+ *  @return The number of converged eigenvalues.
+ *
+ *  @sa SpecDecomp::lobpcg
+ */
+template<typename Mesh, typename DerivedA, typename DerivedB, typename DerivedC>
+unsigned spectrum(const Mesh& mesh,
+                  unsigned k,
+                  Eigen::MatrixBase<DerivedA>& lambdas,
+                  Eigen::MatrixBase<DerivedB>& phis,
+                  const Eigen::MatrixBase<DerivedC>& initial,
+                  SpecOp op = SpecOp::laplace_beltrami,
+                  unsigned max_iter = 1000,
+                  double tolerance = 1e-10);
+
+/** Multilevel spectral approximation of a mesh.
+ *
+ *  The low-frequency eigenfunctions are smooth, so they are well represented
+ *  on a coarser level. The Laplacian is coarsened by greedy aggregation of
+ *  neighboring vertices until the next level would have fewer than
+ *  coarse_size vertices. The eigenvalue problem is solved exactly on the
+ *  coarsest level, and the eigenfunctions are then prolonged level by level
+ *  and refined with a few subspace iterations.
+ *
+ *  @param mesh The input mesh.
+ *  @param k The number of eigenvalues to compute.
+ *  @param lambdas The output approximate eigenvalues, sorted in ascending
+ *  order.
+ *  @param phis The output approximate eigenfunctions corresponding to the
+ *  eigenvalues.
+ *  @param errors The output error bounds of the eigenvalues, the distance from
+ *  each approximate eigenvalue of the symmetric Laplacian to its nearest exact
+ *  one is at most this value.
+ *  @param op The Laplace operator to use.
+ *  @param coarse_size The minimum number of vertices of the coarsest level,
+ *  the larger the more accurate.
+ *  @param refinements The number of subspace iterations on each level.
+ *  @param max_iter The maximum number of iterations on the coarsest level.
+ *  @param tolerance The tolerance of accuracy loss on the coarsest level.
+ *
+ *  @return The number of eigenvalues.
+ *
+ *  @sa SpecDecomp::multilevel
+ */
+template<typename Mesh, typename DerivedA, typename DerivedB, typename DerivedC>
+unsigned multilevel_spectrum(const Mesh& mesh,
+                             unsigned k,
+                             Eigen::MatrixBase<DerivedA>& lambdas,
+                             Eigen::MatrixBase<DerivedB>& phis,
+                             Eigen::MatrixBase<DerivedC>& errors,
+                             SpecOp op = SpecOp::laplace_beltrami,
+                             unsigned coarse_size = 5000,
+                             unsigned refinements = 2,
+                             unsigned max_iter = 1000,
+                             double tolerance = 1e-10);
+
 /** @}*/
 } // namespace Euclid
 
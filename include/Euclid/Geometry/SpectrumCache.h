@@ -0,0 +1,138 @@
+/** Persistent cache of mesh spectra.
+ *
+ *  Spectral decomposition of a large mesh with hundreds of eigenpairs could
+ *  take minutes, while the same mesh is often decomposed again and again by
+ *  different descriptors or across runs. This package stores the spectrum of
+ *  each mesh on disk, keyed by a hash of the mesh content and the requested
+ *  decomposition, and serves it back through a memory mapping, so that a
+ *  cached spectrum is never parsed or copied unless asked for.
+ *
+ *  When a cached spectrum has fewer eigenpairs than requested, the cached ones
+ *  are kept and only the missing ones are computed, with the cached
+ *  eigenvectors deflated from the eigen solver.
+ *
+ *  Entries are replaced atomically through Boost.Filesystem, which is not
+ *  header only and needs to be linked.
+ *
+ *  @defgroup PkgSpectrumCache SpectrumCache
+ *  @ingroup PkgGeometry
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <Eigen/Core>
+#include <Euclid/Geometry/Spectral.h>
+
+namespace Euclid
+{
+/** @{*/
+
+/** A spectrum mapped from a cache file.
+ *
+ *  The eigenvalues and eigenfunctions are read-only views into the mapped
+ *  file, they stay valid as long as this object is alive.
+ *
+ *  @tparam T Scalar type.
+ */
+template<typename T>
+class MappedSpectrum
+{
+public:
+    using Vec = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    using Mat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+public:
+    /** Map a cache file.
+     *
+     *  @param filename The cache file.
+     */
+    explicit MappedSpectrum(const std::string& filename);
+
+    /** The content hash recorded in the file. */
+    uint64_t hash() const;
+
+    /** Number of eigenpairs. */
+    unsigned size() const;
+
+    /** The eigenvalues, sorted in ascending order. */
+    Eigen::Map<const Vec> eigenvalues() const;
+
+    /** The eigenfunctions, one per column. */
+    Eigen::Map<const Mat> eigenfunctions() const;
+
+private:
+    boost::interprocess::file_mapping _file;
+    boost::interprocess::mapped_region _region;
+    uint64_t _hash;
+    Eigen::Index _nv;
+    Eigen::Index _k;
+    const T* _lambdas;
+    const T* _phis;
+};
+
+/** A persistent cache of mesh spectra on disk.
+ *
+ *  Each entry is a binary file written by serialize(), holding the content
+ *  hash, the eigenvalues and the eigenfunctions. The number of eigenpairs is
+ *  not part of the key, so an entry could be extended later.
+ *
+ *  @sa spectrum
+ */
+class SpectrumCache
+{
+public:
+    /** Create a cache in a directory.
+     *
+     *  @param directory An existing directory to store the cache files.
+     */
+    explicit SpectrumCache(const std::string& directory);
+
+    /** Hash of a mesh and a decomposition.
+     *
+     *  The hash covers the vertex positions, the face indices, the scalar
+     *  type, the operator and the decomposition.
+     */
+    template<typename Mesh>
+    uint64_t hash(const Mesh& mesh, SpecOp op, SpecDecomp decomp) const;
+
+    /** Path of the cache file of a mesh and a decomposition.
+     *
+     */
+    template<typename Mesh>
+    std::string path(const Mesh& mesh, SpecOp op, SpecDecomp decomp) const;
+
+    /** Spectral decomposition of a mesh through the cache.
+     *
+     *  Serve the spectrum from the cache if enough eigenpairs are stored,
+     *  otherwise compute the missing ones and update the cache. A corrupted
+     *  entry is computed again and overwritten.
+     *
+     *  @return The number of eigenvalues.
+     *
+     *  @sa spectrum
+     */
+    template<typename Mesh, typename DerivedA, typename DerivedB>
+    unsigned spectrum(const Mesh& mesh,
+                      unsigned k,
+                      Eigen::MatrixBase<DerivedA>& lambdas,
+                      Eigen::MatrixBase<DerivedB>& phis,
+                      SpecOp op = SpecOp::laplace_beltrami,
+                      SpecDecomp decomp = SpecDecomp::symmetric,
+                      unsigned max_iter = 1000,
+                      double tolerance = 1e-10) const;
+
+private:
+    std::string _filename(uint64_t key) const;
+
+private:
+    std::string _directory;
+};
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/SpectrumCache.cpp"
@@ -20,12 +20,19 @@
  *  Spectral Mesh Processing.
  *  Computer Graphics Forum, 2010.
  *
+ *  [5] Taubin, G.
+ *  Estimating the Tensor of Curvature of a Surface from a Polyhedral
+ *  Approximation.
+ *  Proceedings of the IEEE International Conference on Computer Vision, 1995.
+ *
  *  @defgroup PkgTriMeshGeometry TriMeshGeometry
  *  @ingroup PkgGeometry
  */
 #pragma once
 
 #include <tuple>
+#include <vector>
+#include <Eigen/Core>
 #include <Eigen/SparseCore>
 #include <CGAL/boost/graph/properties.h>
 
@@ -379,6 +386,74 @@ template<
                                                   value_type>::Kernel::FT>
 std::vector<T> gaussian_curvatures(const Mesh& mesh);
 
+/** Curvatures of all vertices on the mesh.
+ *
+ *  Per-vertex quantities are stored in structure-of-arrays form, i.e. the
+ *  i-th row of each member corresponds to the vertex with index i. The
+ *  principal directions are unit vectors in the tangent plane, stored as one
+ *  column per coordinate.
+ *
+ *  @sa principal_curvatures
+ */
+template<typename T>
+struct Curvatures
+{
+    /** Mean curvatures, positive on convex regions. */
+    Eigen::Matrix<T, Eigen::Dynamic, 1> mean;
+    /** Gaussian curvatures. */
+    Eigen::Matrix<T, Eigen::Dynamic, 1> gaussian;
+    /** Maximum principal curvatures. */
+    Eigen::Matrix<T, Eigen::Dynamic, 1> k_max;
+    /** Minimum principal curvatures. */
+    Eigen::Matrix<T, Eigen::Dynamic, 1> k_min;
+    /** Directions of the maximum principal curvatures. */
+    Eigen::Matrix<T, Eigen::Dynamic, 3> d_max;
+    /** Directions of the minimum principal curvatures. */
+    Eigen::Matrix<T, Eigen::Dynamic, 3> d_min;
+};
+
+/** Mean curvatures of all vertices on the mesh.
+ *
+ *  Discrete mean curvature derived from the mean curvature normal, i.e. the
+ *  cotangent Laplacian of the vertex positions normalized by the mixed voronoi
+ *  area. The sign is positive on convex regions.
+ *
+ *  @tparam Mesh Mesh type.
+ *  @tparam T Optional, derived from Mesh.
+ *
+ *  @sa principal_curvatures
+ */
+template<
+    typename Mesh,
+    typename T = typename CGAL::Kernel_traits<typename boost::property_traits<
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type>::
+                                                  value_type>::Kernel::FT>
+std::vector<T> mean_curvatures(const Mesh& mesh);
+
+/** Principal curvatures and directions of all vertices on the mesh.
+ *
+ *  All curvatures are computed in one batched pass. The cotangent weights,
+ *  interior angles and mixed voronoi areas of every face are evaluated once,
+ *  then each vertex gathers them from its incident faces to form the mean
+ *  curvature, the Gaussian curvature, and the curvature tensor whose
+ *  eigenvectors give the principal directions. The principal curvatures are
+ *  @f$H\pm\sqrt{H^2-K}@f$ as described in [3], and the principal directions
+ *  are estimated from the curvature tensor described in [5].
+ *
+ *  @param mesh The input mesh.
+ *  @param directions Whether to compute the principal directions, the
+ *  direction members of the result are left empty if false.
+ *
+ *  @tparam Mesh Mesh type.
+ *  @tparam T Optional, derived from Mesh.
+ */
+template<
+    typename Mesh,
+    typename T = typename CGAL::Kernel_traits<typename boost::property_traits<
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type>::
+                                                  value_type>::Kernel::FT>
+Curvatures<T> principal_curvatures(const Mesh& mesh, bool directions = true);
+
 /** Adjacency matrix of the mesh.
  *
  *  Return the unweighted adjacency matrix as well as the degree matrix of a
@@ -413,6 +488,10 @@ std::tuple<Eigen::SparseMatrix<T>, Eigen::SparseMatrix<T>> adjacency_matrix(
  *  elements are positive and the others are negative, thus forming a positive
  *  smei-definitive matrix.
  *
+ *  The matrix is assembled face by face, the same way as in OperatorRegistry
+ *  and batch_geometry, so on a mesh with boundary an edge on the border only
+ *  gets the cotangent of the angle opposite to it in its single incident face.
+ *
  *  @tparam Mesh Mesh type.
  *  @tparam T Optional, derived from Mesh.
  *
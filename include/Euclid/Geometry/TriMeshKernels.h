@@ -0,0 +1,89 @@
+/** Geometry kernels on raw triangle arrays.
+ *
+ *  This package contains functions to compute per-face and per-vertex
+ *  geometric quantities directly from the flat position and index buffers
+ *  produced by the IO package, e.g. read_ply(), so that a mesh data structure
+ *  is not needed at all.
+ *
+ *  The faces are processed in blocks. Within a block, the corner positions are
+ *  gathered into structure-of-arrays form and all the arithmetic is carried
+ *  out by Eigen array expressions, which are vectorized to the widest SIMD
+ *  instruction set enabled at compile time, e.g. 8 floats with AVX or 16
+ *  floats with AVX-512. Blocks are distributed among threads if OpenMP is
+ *  enabled.
+ *
+ *  All kernels are templated on the scalar type of the positions, so feeding
+ *  float buffers computes everything in single precision and halves the
+ *  memory traffic compared with double.
+ *
+ *  @defgroup PkgTriMeshKernels TriMeshKernels
+ *  @ingroup PkgGeometry
+ */
+#pragma once
+
+#include <vector>
+
+namespace Euclid
+{
+/** @{*/
+
+/** Normals of all faces of a triangle mesh.
+ *
+ *  @param positions Vertex positions, 3 values per vertex.
+ *  @param indices Triangle indices, 3 values per face.
+ *  @param normals Output unit face normals, 3 values per face. Degenerate
+ *  faces are assigned zero vectors.
+ */
+template<typename FT, typename IT>
+void face_normals(const std::vector<FT>& positions,
+                  const std::vector<IT>& indices,
+                  std::vector<FT>& normals);
+
+/** Areas of all faces of a triangle mesh.
+ *
+ *  @param positions Vertex positions, 3 values per vertex.
+ *  @param indices Triangle indices, 3 values per face.
+ *  @param areas Output face areas, 1 value per face.
+ */
+template<typename FT, typename IT>
+void face_areas(const std::vector<FT>& positions,
+                const std::vector<IT>& indices,
+                std::vector<FT>& areas);
+
+/** Cotangent weights of all the corners of a triangle mesh.
+ *
+ *  The i-th value of a face is the cotangent of the interior angle at its i-th
+ *  vertex, i.e. the weight of the opposite edge used in the cotangent
+ *  Laplacian.
+ *
+ *  @param positions Vertex positions, 3 values per vertex.
+ *  @param indices Triangle indices, 3 values per face.
+ *  @param cotangents Output cotangents, 3 values per face.
+ *
+ *  @sa cotangent_matrix
+ */
+template<typename FT, typename IT>
+void cotangent_weights(const std::vector<FT>& positions,
+                       const std::vector<IT>& indices,
+                       std::vector<FT>& cotangents);
+
+/** Angle defects of all vertices of a triangle mesh.
+ *
+ *  The angle defect of a vertex is @f$2\pi@f$ minus the sum of the interior
+ *  angles incident to it, i.e. the integrated Gaussian curvature.
+ *
+ *  @param positions Vertex positions, 3 values per vertex.
+ *  @param indices Triangle indices, 3 values per face.
+ *  @param defects Output angle defects, 1 value per vertex.
+ *
+ *  @sa gaussian_curvature
+ */
+template<typename FT, typename IT>
+void angle_defects(const std::vector<FT>& positions,
+                   const std::vector<IT>& indices,
+                   std::vector<FT>& defects);
+
+/** @}*/
+} // namespace Euclid
+
+#include "src/TriMeshKernels.cpp"
@@ -0,0 +1,126 @@
+#include <Euclid/Geometry/TriMeshKernels.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+namespace Euclid
+{
+
+namespace _impl
+{
+
+// Buffers owned by one thread and reused from mesh to mesh
+template<typename T>
+struct BatchScratch
+{
+    std::vector<T> positions;
+    std::vector<int> indices;
+    std::vector<T> weights;
+    std::vector<Eigen::Triplet<T>> triplets;
+};
+
+template<typename Mesh, typename T>
+void batch_one(const Mesh& mesh,
+               const BatchQuantities& quantities,
+               BatchScratch<T>& scratch,
+               BatchGeometry<T>& result)
+{
+    auto& positions = scratch.positions;
+    auto& indices = scratch.indices;
+    extract_mesh<3>(mesh, positions, indices);
+    const auto nv = static_cast<int>(positions.size() / 3);
+
+    if (quantities.face_normals) {
+        Euclid::face_normals(positions, indices, result.face_normals);
+    }
+    if (quantities.face_areas) {
+        Euclid::face_areas(positions, indices, result.face_areas);
+    }
+    if (quantities.curvatures) {
+        result.curvatures = _impl::curvatures(
+            positions, indices, quantities.principal_directions);
+    }
+    if (quantities.cotangent_matrix) {
+        auto& triplets = scratch.triplets;
+        triplets.clear();
+        cotangent_weights(positions, indices, scratch.weights);
+        scatter_cotangent_laplacian(
+            indices, scratch.weights, [&](int i, int j, T value) {
+                triplets.emplace_back(i, j, value);
+            });
+        result.cotangent_matrix.resize(nv, nv);
+        result.cotangent_matrix.setFromTriplets(triplets.begin(),
+                                                triplets.end());
+        result.cotangent_matrix.makeCompressed();
+    }
+    if (quantities.mass_matrix) {
+        auto& cells = scratch.weights;
+        cells.resize(indices.size());
+        for_each_face_block(
+            positions, indices, [&](const auto& block, size_t first, int n) {
+                for (int c = 0; c < 3; ++c) {
+                    BlockArray<T> cell = block.mixed_voronoi_area(c);
+                    for (int i = 0; i < n; ++i) {
+                        cells[3 * (first + i) + c] = cell(i);
+                    }
+                }
+            });
+        Eigen::Matrix<T, Eigen::Dynamic, 1> areas;
+        areas.setZero(nv);
+        for (size_t c = 0; c < indices.size(); ++c) {
+            areas(indices[c]) += cells[c];
+        }
+        result.mass_matrix = Eigen::SparseMatrix<T>(areas.asDiagonal());
+    }
+    if (quantities.graph_laplacian) {
+        // Each interior edge appears in two faces, keep one of the duplicates
+        auto& triplets = scratch.triplets;
+        triplets.clear();
+        for (size_t c = 0; c < indices.size(); ++c) {
+            const auto f = c - c % 3;
+            const auto a = indices[f + (c + 1) % 3];
+            const auto b = indices[f + (c + 2) % 3];
+            triplets.emplace_back(a, b, 1);
+            triplets.emplace_back(b, a, 1);
+        }
+        Eigen::SparseMatrix<T> adjacency(nv, nv);
+        adjacency.setFromTriplets(triplets.begin(),
+                                  triplets.end(),
+                                  [](const T& a, const T&) { return a; });
+        Eigen::Matrix<T, Eigen::Dynamic, 1> degrees =
+            adjacency * Eigen::Matrix<T, Eigen::Dynamic, 1>::Ones(nv);
+        result.graph_laplacian =
+            Eigen::SparseMatrix<T>(degrees.asDiagonal()) - adjacency;
+        result.graph_laplacian.makeCompressed();
+    }
+}
+
+} // namespace _impl
+
+template<typename ForwardIt, typename T>
+std::vector<BatchGeometry<T>> batch_geometry(
+    ForwardIt first,
+    ForwardIt last,
+    const BatchQuantities& quantities)
+{
+    using Mesh = typename std::iterator_traits<ForwardIt>::value_type;
+
+    std::vector<const Mesh*> meshes;
+    for (; first != last; ++first) {
+        meshes.push_back(&*first);
+    }
+    std::vector<BatchGeometry<T>> results(meshes.size());
+
+    // Meshes differ in size, so they are handed out one at a time to whichever
+    // thread is free, the kernels inside each mesh then run sequentially
+#pragma omp parallel
+    {
+        _impl::BatchScratch<T> scratch;
+
+#pragma omp for schedule(dynamic)
+        for (int i = 0; i < static_cast<int>(meshes.size()); ++i) {
+            _impl::batch_one(*meshes[i], quantities, scratch, results[i]);
+        }
+    }
+    return results;
+}
+
+} // namespace Euclid
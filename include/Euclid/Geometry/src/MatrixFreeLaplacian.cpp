@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <stdexcept>
+
+#include <Euclid/Geometry/TriMeshKernels.h>
+
+namespace Euclid
+{
+
+namespace _impl
+{
+
+// Greedy coloring of the consecutive blocks of faces such that no two blocks
+// of the same color share a vertex. Blocks of color k are blocks[offsets[k]]
+// to blocks[offsets[k + 1] - 1].
+template<typename IT>
+void color_face_blocks(size_t nv,
+                       const std::vector<IT>& indices,
+                       std::vector<size_t>& blocks,
+                       std::vector<size_t>& offsets)
+{
+    std::vector<size_t> vertex_offsets, corners;
+    vertex_corners(nv, indices, vertex_offsets, corners);
+
+    const size_t block_corners = 3 * face_block_size;
+    const auto nblocks = (indices.size() + block_corners - 1) / block_corners;
+    const auto uncolored = static_cast<size_t>(-1);
+    std::vector<size_t> colors(nblocks, uncolored);
+    std::vector<size_t> stamps; // stamps[k] == b if block b can't take color k
+    size_t ncolors = 0;
+    for (size_t b = 0; b < nblocks; ++b) {
+        const auto last = std::min(indices.size(), (b + 1) * block_corners);
+        for (auto c = b * block_corners; c < last; ++c) {
+            const auto v = static_cast<size_t>(indices[c]);
+            for (auto i = vertex_offsets[v]; i < vertex_offsets[v + 1]; ++i) {
+                const auto color = colors[corners[i] / block_corners];
+                if (color != uncolored) { stamps[color] = b; }
+            }
+        }
+        size_t color = 0;
+        while (color < ncolors && stamps[color] == b) {
+            ++color;
+        }
+        if (color == ncolors) {
+            stamps.push_back(uncolored);
+            ++ncolors;
+        }
+        colors[b] = color;
+    }
+
+    offsets.assign(ncolors + 1, 0);
+    for (auto color : colors) {
+        ++offsets[color + 1];
+    }
+    for (size_t k = 0; k < ncolors; ++k) {
+        offsets[k + 1] += offsets[k];
+    }
+    std::vector<size_t> slots(offsets.begin(), offsets.end() - 1);
+    blocks.resize(nblocks);
+    for (size_t b = 0; b < nblocks; ++b) {
+        blocks[slots[colors[b]]++] = b;
+    }
+}
+
+} // namespace _impl
+
+template<typename FT, typename IT>
+void MatrixFreeLaplacian<FT, IT>::build(const std::vector<FT>& positions,
+                                        const std::vector<IT>& indices)
+{
+    _impl::check_buffers(positions, indices);
+    _positions = &positions;
+    _indices = &indices;
+    _nv = static_cast<Index>(positions.size() / 3);
+    _diagonal.resize(0);
+    _impl::color_face_blocks(
+        static_cast<size_t>(_nv), indices, _blocks, _color_offsets);
+}
+
+template<typename FT, typename IT>
+void MatrixFreeLaplacian<FT, IT>::set_diagonal(const Vec& diagonal)
+{
+    if (diagonal.size() != 0 && diagonal.size() != rows()) {
+        throw std::invalid_argument("Diagonal size doesn't match.");
+    }
+    _diagonal = diagonal;
+}
+
+template<typename FT, typename IT>
+Eigen::Index MatrixFreeLaplacian<FT, IT>::rows() const
+{
+    return _nv;
+}
+
+template<typename FT, typename IT>
+Eigen::Index MatrixFreeLaplacian<FT, IT>::cols() const
+{
+    return rows();
+}
+
+template<typename FT, typename IT>
+typename MatrixFreeLaplacian<FT, IT>::Vec
+MatrixFreeLaplacian<FT, IT>::diagonal() const
+{
+    Vec d = _diagonal.size() == 0 ? Vec::Zero(rows()) : _diagonal;
+    const auto& indices = *_indices;
+    _for_each_block(
+        [&](size_t first, int n, const _impl::BlockArray<FT>* cot) {
+            _impl::scatter_cotangent_laplacian(
+                indices,
+                first,
+                n,
+                [&](size_t f, int c) { return cot[c](f - first); },
+                [&](IT i, IT j, FT value) {
+                    if (i == j) {
+                        d(i) += value;
+                    }
+                });
+        });
+    return d;
+}
+
+template<typename FT, typename IT>
+template<typename DerivedY>
+void MatrixFreeLaplacian<FT, IT>::apply(const Eigen::Ref<const Mat>& x,
+                                        Eigen::MatrixBase<DerivedY>& y,
+                                        FT alpha) const
+{
+    auto& ye = y.derived();
+    if (_diagonal.size() != 0) {
+        ye += alpha * (_diagonal.asDiagonal() * x);
+    }
+
+    const auto& indices = *_indices;
+    const auto scale = alpha * static_cast<FT>(0.5);
+    _for_each_block(
+        [&](size_t first, int n, const _impl::BlockArray<FT>* cot) {
+            IT v[3][_impl::face_block_size];
+            for (int i = 0; i < n; ++i) {
+                const auto f = 3 * (first + i);
+                v[0][i] = indices[f + 0];
+                v[1][i] = indices[f + 1];
+                v[2][i] = indices[f + 2];
+            }
+            _impl::BlockArray<FT> x0(n), x1(n), x2(n);
+            _impl::BlockArray<FT> y0, y1, y2;
+            for (Index col = 0; col < x.cols(); ++col) {
+                const auto xc = x.col(col);
+                auto yc = ye.col(col);
+                for (int i = 0; i < n; ++i) {
+                    x0(i) = xc(v[0][i]);
+                    x1(i) = xc(v[1][i]);
+                    x2(i) = xc(v[2][i]);
+                }
+                y0 = scale * (cot[2] * (x0 - x1) - cot[1] * (x2 - x0));
+                y1 = scale * (cot[0] * (x1 - x2) - cot[2] * (x0 - x1));
+                y2 = scale * (cot[1] * (x2 - x0) - cot[0] * (x1 - x2));
+                for (int i = 0; i < n; ++i) {
+                    yc(v[0][i]) += y0(i);
+                    yc(v[1][i]) += y1(i);
+                    yc(v[2][i]) += y2(i);
+                }
+            }
+        });
+}
+
+template<typename FT, typename IT>
+void MatrixFreeLaplacian<FT, IT>::perform_op(const FT* x_in, FT* y_out) const
+{
+    Eigen::Map<const Vec> x(x_in, rows());
+    Eigen::Map<Vec> y(y_out, rows());
+    y.setZero();
+    apply(x, y);
+}
+
+template<typename FT, typename IT>
+template<typename Fn>
+void MatrixFreeLaplacian<FT, IT>::_for_each_block(Fn fn) const
+{
+    const auto& positions = *_positions;
+    const auto& indices = *_indices;
+    const auto nf = indices.size() / 3;
+    const auto ncolors = static_cast<int>(_color_offsets.size()) - 1;
+
+    // No two blocks of a color share a vertex, so they scatter into disjoint
+    // entries and run concurrently, one color after the other
+#pragma omp parallel
+    {
+        _impl::FaceBlock<FT> block;
+        _impl::BlockArray<FT> cot[3];
+        for (int color = 0; color < ncolors; ++color) {
+            const auto begin = static_cast<int>(_color_offsets[color]);
+            const auto end = static_cast<int>(_color_offsets[color + 1]);
+
+#pragma omp for schedule(static)
+            for (int b = begin; b < end; ++b) {
+                const auto first = _blocks[b] * _impl::face_block_size;
+                const auto n = static_cast<int>(
+                    std::min<size_t>(_impl::face_block_size, nf - first));
+                block.load(positions, indices, first, n);
+                for (int c = 0; c < 3; ++c) {
+                    cot[c] = block.cotangent(c);
+                }
+                fn(first, n, cot);
+            }
+        }
+    }
+}
+
+} // namespace Euclid
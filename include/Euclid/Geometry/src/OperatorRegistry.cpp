@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <iterator>
+
+#include <Euclid/Geometry/TriMeshKernels.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+namespace Euclid
+{
+
+template<typename Mesh>
+void OperatorRegistry<Mesh>::build(const Mesh& mesh, const VertexArea& method)
+{
+    auto vimap = get(boost::vertex_index, mesh);
+    const auto nv = static_cast<int>(num_vertices(mesh));
+
+    // Each column holds the diagonal plus the one-ring, sorted by row
+    _outer.assign(nv + 1, 0);
+    for (auto v : vertices(mesh)) {
+        int i = get(vimap, v);
+        auto ring = halfedges_around_target(v, mesh);
+        _outer[i + 1] = 1 + std::distance(ring.begin(), ring.end());
+    }
+    for (int i = 0; i < nv; ++i) {
+        _outer[i + 1] += _outer[i];
+    }
+    _inner.resize(_outer[nv]);
+    for (auto v : vertices(mesh)) {
+        int i = get(vimap, v);
+        auto k = _outer[i];
+        _inner[k++] = i;
+        for (auto he : halfedges_around_target(v, mesh)) {
+            _inner[k++] = get(vimap, source(he, mesh));
+        }
+        std::sort(_inner.begin() + _outer[i], _inner.begin() + _outer[i + 1]);
+    }
+    _cols.resize(_inner.size());
+    _diag.resize(nv);
+    for (int i = 0; i < nv; ++i) {
+        std::fill(
+            _cols.begin() + _outer[i], _cols.begin() + _outer[i + 1], i);
+        _diag[i] = index(i, i);
+    }
+
+    // Graph Laplacian
+    const auto nnz = nonzeros();
+    _degree.setZero(nnz);
+    _graph_laplacian.setConstant(nnz, -1);
+    for (int i = 0; i < nv; ++i) {
+        _degree(_diag[i]) = _outer[i + 1] - _outer[i] - 1;
+        _graph_laplacian(_diag[i]) = _degree(_diag[i]);
+    }
+
+    // Cotangent Laplacian, scattered from the per-corner weights
+    std::vector<FT> positions;
+    std::vector<StorageIndex> indices;
+    std::vector<FT> cotangents;
+    extract_mesh<3>(mesh, positions, indices);
+    cotangent_weights(positions, indices, cotangents);
+    _cotangent_laplacian.setZero(nnz);
+    _impl::scatter_cotangent_laplacian(
+        indices, cotangents, [&](int i, int j, FT value) {
+            _cotangent_laplacian(i == j ? _diag[i] : index(i, j)) += value;
+        });
+
+    // Mass matrix
+    _mass.setZero(nnz);
+    for (auto v : vertices(mesh)) {
+        _mass(_diag[get(vimap, v)]) = vertex_area(v, mesh, method);
+    }
+}
+
+template<typename Mesh>
+int OperatorRegistry<Mesh>::size() const
+{
+    return static_cast<int>(_diag.size());
+}
+
+template<typename Mesh>
+int OperatorRegistry<Mesh>::nonzeros() const
+{
+    return static_cast<int>(_inner.size());
+}
+
+template<typename Mesh>
+int OperatorRegistry<Mesh>::index(int i, int j) const
+{
+    auto beg = _inner.begin() + _outer[j];
+    auto end = _inner.begin() + _outer[j + 1];
+    auto iter = std::lower_bound(beg, end, i);
+    if (iter == end || *iter != i) {
+        return -1;
+    }
+    return static_cast<int>(iter - _inner.begin());
+}
+
+template<typename Mesh>
+const typename OperatorRegistry<Mesh>::Vec&
+OperatorRegistry<Mesh>::graph_laplacian() const
+{
+    return _graph_laplacian;
+}
+
+template<typename Mesh>
+const typename OperatorRegistry<Mesh>::Vec&
+OperatorRegistry<Mesh>::degree() const
+{
+    return _degree;
+}
+
+template<typename Mesh>
+const typename OperatorRegistry<Mesh>::Vec&
+OperatorRegistry<Mesh>::cotangent_laplacian() const
+{
+    return _cotangent_laplacian;
+}
+
+template<typename Mesh>
+const typename OperatorRegistry<Mesh>::Vec&
+OperatorRegistry<Mesh>::mass() const
+{
+    return _mass;
+}
+
+template<typename Mesh>
+typename OperatorRegistry<Mesh>::Vec
+OperatorRegistry<Mesh>::heat(FT t) const
+{
+    return _mass + t * _cotangent_laplacian;
+}
+
+template<typename Mesh>
+typename OperatorRegistry<Mesh>::Vec
+OperatorRegistry<Mesh>::diagonal(const Vec& values) const
+{
+    Vec d(size());
+    for (int i = 0; i < size(); ++i) {
+        d(i) = values(_diag[i]);
+    }
+    return d;
+}
+
+template<typename Mesh>
+typename OperatorRegistry<Mesh>::Vec
+OperatorRegistry<Mesh>::scale(const Vec& values, const Vec& d) const
+{
+    Vec result(nonzeros());
+    for (int k = 0; k < nonzeros(); ++k) {
+        result(k) = d(_inner[k]) * values(k) * d(_cols[k]);
+    }
+    return result;
+}
+
+template<typename Mesh>
+Eigen::Map<const typename OperatorRegistry<Mesh>::SpMat>
+OperatorRegistry<Mesh>::view(const Vec& values) const
+{
+    return Eigen::Map<const SpMat>(size(),
+                                   size(),
+                                   nonzeros(),
+                                   _outer.data(),
+                                   _inner.data(),
+                                   values.data());
+}
+
+template<typename Mesh>
+typename OperatorRegistry<Mesh>::SpMat
+OperatorRegistry<Mesh>::matrix(const Vec& values) const
+{
+    return SpMat(view(values));
+}
+
+} // namespace Euclid
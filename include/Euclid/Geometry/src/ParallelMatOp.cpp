@@ -0,0 +1,88 @@
+#include <stdexcept>
+
+namespace Euclid
+{
+
+template<typename T>
+ParallelSymMatProd<T>::ParallelSymMatProd(const SpMat& mat) : _mat(mat)
+{}
+
+template<typename T>
+int ParallelSymMatProd<T>::rows() const
+{
+    return static_cast<int>(_mat.rows());
+}
+
+template<typename T>
+int ParallelSymMatProd<T>::cols() const
+{
+    return static_cast<int>(_mat.cols());
+}
+
+template<typename T>
+void ParallelSymMatProd<T>::perform_op(const T* x_in, T* y_out) const
+{
+    const auto outer = _mat.outerIndexPtr();
+    const auto inner = _mat.innerIndexPtr();
+    const auto values = _mat.valuePtr();
+    const auto nnz = _mat.innerNonZeroPtr();
+
+    // Column i of a symmetric matrix is also its row i, so every thread owns
+    // a range of rows and no write is shared
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < rows(); ++i) {
+        const auto end = nnz == nullptr ? outer[i + 1] : outer[i] + nnz[i];
+        T sum = 0;
+        for (auto k = outer[i]; k < end; ++k) {
+            sum += values[k] * x_in[inner[k]];
+        }
+        y_out[i] = sum;
+    }
+}
+
+template<typename T>
+ParallelSymShiftSolve<T>::ParallelSymShiftSolve(const SpMat& mat) : _mat(mat)
+{
+    if (mat.rows() != mat.cols()) {
+        throw std::invalid_argument("Matrix must be square.");
+    }
+}
+
+template<typename T>
+int ParallelSymShiftSolve<T>::rows() const
+{
+    return static_cast<int>(_mat.rows());
+}
+
+template<typename T>
+int ParallelSymShiftSolve<T>::cols() const
+{
+    return static_cast<int>(_mat.cols());
+}
+
+template<typename T>
+void ParallelSymShiftSolve<T>::set_shift(T sigma)
+{
+    SpMat shifted = _mat;
+    if (sigma != 0) {
+        SpMat identity(_mat.rows(), _mat.cols());
+        identity.setIdentity();
+        shifted -= sigma * identity;
+    }
+    _solver.compute(shifted);
+    if (_solver.info() != Eigen::Success) {
+        throw std::invalid_argument(
+            "Matrix factorization failed in the shift-solve operation.");
+    }
+}
+
+template<typename T>
+void ParallelSymShiftSolve<T>::perform_op(const T* x_in, T* y_out) const
+{
+    using Vec = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    Eigen::Map<const Vec> x(x_in, rows());
+    Eigen::Map<Vec> y(y_out, rows());
+    y.noalias() = _solver.solve(x);
+}
+
+} // namespace Euclid
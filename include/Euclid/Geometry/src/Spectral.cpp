@@ -1,13 +1,20 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <CGAL/boost/graph/properties.h>
+#include <Eigen/Eigenvalues>
+#include <Eigen/QR>
 #include <Eigen/SparseCore>
-#include <Euclid/Geometry/TriMeshGeometry.h>
+#include <Euclid/Geometry/OperatorRegistry.h>
+#include <Euclid/Geometry/ParallelMatOp.h>
 #include <Euclid/Util/Assert.h>
 #include <Spectra/MatOp/SparseCholesky.h>
-#include <Spectra/MatOp/SparseSymMatProd.h>
-#include <Spectra/MatOp/SparseSymShiftSolve.h>
 #include <Spectra/SymEigsShiftSolver.h>
+#include <Spectra/SymEigsSolver.h>
 #include <Spectra/SymGEigsSolver.h>
 
 namespace Euclid
@@ -16,27 +23,24 @@ namespace Euclid
 namespace _impl
 {
 
-template<typename Mesh, typename T>
-void get_mat(const Mesh& mesh,
-             SpecOp op,
-             Eigen::SparseMatrix<T>& S,
-             Eigen::SparseMatrix<T>& D)
+// Values of the operator and the diagonal of its mass over a shared pattern
+template<typename Mesh, typename Vec>
+void get_mat(const OperatorRegistry<Mesh>& ops, SpecOp op, Vec& s, Vec& d)
 {
     if (op == SpecOp::laplace_beltrami) {
-        S = Euclid::cotangent_matrix(mesh);
-        D = Euclid::mass_matrix(mesh);
+        s = ops.cotangent_laplacian();
+        d = ops.diagonal(ops.mass());
     }
     else {
-        auto result = Euclid::adjacency_matrix(mesh);
-        auto A = std::get<0>(result);
-        D = std::get<1>(result);
-        S = D - A;
+        s = ops.graph_laplacian();
+        d = ops.diagonal(ops.degree());
     }
 }
 
-template<typename T, typename DerivedA, typename DerivedB>
-unsigned sym_solve(const Eigen::SparseMatrix<T>& S,
-                   const Eigen::SparseMatrix<T>& D,
+template<typename Mesh, typename Vec, typename DerivedA, typename DerivedB>
+unsigned sym_solve(const OperatorRegistry<Mesh>& ops,
+                   const Vec& s,
+                   const Vec& d,
                    int k,
                    int nv,
                    unsigned max_iter,
@@ -44,16 +48,18 @@ unsigned sym_solve(const Eigen::SparseMatrix<T>& S,
                    Eigen::MatrixBase<DerivedA>& lambdas,
                    Eigen::MatrixBase<DerivedB>& phis)
 {
-    Eigen::SparseMatrix<T> B =
-        D.unaryExpr([](T v) { return v == 0 ? 0 : 1 / std::sqrt(v); });
-    Eigen::SparseMatrix<T> L = B * S * B;
+    using T = typename Vec::Scalar;
+
+    // L = BSB is formed elementwise on the shared pattern
+    Vec b = d.unaryExpr([](T v) { return v == 0 ? 0 : 1 / std::sqrt(v); });
+    Eigen::SparseMatrix<T> L = ops.matrix(ops.scale(s, b));
 
     // use shift-invert mode to get the smallest eigenvalues fast
     auto convergence = std::min(2 * k + 1, nv);
-    Spectra::SparseSymShiftSolve<T> op(L);
+    ParallelSymShiftSolve<T> op(L);
     Spectra::SymEigsShiftSolver<T,
                                 Spectra::LARGEST_MAGN,
-                                Spectra::SparseSymShiftSolve<T>>
+                                ParallelSymShiftSolve<T>>
         eigensolver(&op, k, convergence, 0.0f);
     eigensolver.init();
     unsigned n = eigensolver.compute(
@@ -63,13 +69,14 @@ unsigned sym_solve(const Eigen::SparseMatrix<T>& S,
             "Unable to compute eigen values of the Laplacian matrix.");
     }
     lambdas = eigensolver.eigenvalues();
-    phis = B * eigensolver.eigenvectors();
+    phis = b.asDiagonal() * eigensolver.eigenvectors();
     return n;
 }
 
-template<typename T, typename DerivedA, typename DerivedB>
-unsigned gen_solve(const Eigen::SparseMatrix<T>& S,
-                   const Eigen::SparseMatrix<T>& D,
+template<typename Mesh, typename Vec, typename DerivedA, typename DerivedB>
+unsigned gen_solve(const OperatorRegistry<Mesh>& ops,
+                   const Vec& s,
+                   const Vec& d,
                    int k,
                    int nv,
                    unsigned max_iter,
@@ -77,12 +84,16 @@ unsigned gen_solve(const Eigen::SparseMatrix<T>& S,
                    Eigen::MatrixBase<DerivedA>& lambdas,
                    Eigen::MatrixBase<DerivedB>& phis)
 {
+    using T = typename Vec::Scalar;
+
+    Eigen::SparseMatrix<T> S = ops.matrix(s);
+    Eigen::SparseMatrix<T> D(d.asDiagonal());
     int convergence = std::min(2 * k + 1, nv);
-    Spectra::SparseSymMatProd<T> op_a(S);
+    ParallelSymMatProd<T> op_a(S);
     Spectra::SparseCholesky<T> op_b(D);
     Spectra::SymGEigsSolver<T,
                             Spectra::SMALLEST_MAGN,
-                            Spectra::SparseSymMatProd<T>,
+                            ParallelSymMatProd<T>,
                             Spectra::SparseCholesky<T>,
                             Spectra::GEIGS_MODE::GEIGS_CHOLESKY>
         eigensolver(&op_a, &op_b, k, convergence);
@@ -98,6 +109,524 @@ unsigned gen_solve(const Eigen::SparseMatrix<T>& S,
     return n;
 }
 
+// Transformation that orthonormalizes the columns of a block, which might be
+// ill-conditioned or rank deficient, through the eigen decomposition of its
+// Gram matrix with the nearly dependent directions dropped [4]
+template<typename Mat>
+Mat svqb(const Mat& block)
+{
+    using T = typename Mat::Scalar;
+    using Vec = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+    Vec scale = block.colwise().norm().transpose();
+    scale = scale.unaryExpr([](T v) { return v == 0 ? 0 : 1 / v; });
+    Mat gram = block.transpose() * block;
+    gram = scale.asDiagonal() * gram * scale.asDiagonal();
+    Eigen::SelfAdjointEigenSolver<Mat> solver(gram);
+    const Vec& sigma = solver.eigenvalues();
+    const auto drop = sigma(sigma.size() - 1) *
+                      std::sqrt(std::numeric_limits<T>::epsilon());
+    Eigen::Index first = 0;
+    while (first < sigma.size() && sigma(first) <= drop) {
+        ++first;
+    }
+    const auto rank = sigma.size() - first;
+
+    Mat transform = solver.eigenvectors().rightCols(rank);
+    transform = scale.asDiagonal() * transform;
+    transform *= sigma.tail(rank).cwiseSqrt().cwiseInverse().asDiagonal();
+    return transform;
+}
+
+// Orthonormalize a block against an orthonormal one and then within itself,
+// twice so that the orthogonality is kept in floating point
+template<typename Mat>
+void orthonormalize(const Mat& basis, Mat& block)
+{
+    for (int pass = 0; pass < 2 && block.cols() > 0; ++pass) {
+        if (basis.cols() > 0) {
+            Mat coefs = basis.transpose() * block;
+            block -= basis * coefs;
+        }
+        Mat transform = svqb(block);
+        block = block * transform;
+    }
+}
+
+// Rayleigh-Ritz projection onto an orthonormal block, output the coefficients
+// of the first m Ritz vectors and their Ritz values in ascending order
+template<typename Mat, typename Vec>
+void rayleigh_ritz(const Mat& basis,
+                   const Mat& image,
+                   int m,
+                   Mat& coefs,
+                   Vec& values)
+{
+    Mat reduced = basis.transpose() * image;
+    Eigen::SelfAdjointEigenSolver<Mat> solver(reduced);
+    const auto r = std::min<Eigen::Index>(m, reduced.cols());
+    coefs = solver.eigenvectors().leftCols(r);
+    values = solver.eigenvalues().head(r);
+}
+
+// Number of vectors in the block for k eigenpairs, a few guard vectors beyond
+// k speed up the convergence of the last ones
+inline int block_size(int k, int nv)
+{
+    return std::min(k + std::max(k / 10, 5), nv);
+}
+
+// Locally optimal block preconditioned conjugate gradient iteration [3, 4] for
+// the smallest eigenpairs of a symmetric positive semi-definite matrix.
+// X holds the initial block on input and the Ritz vectors on output, along
+// with their Ritz values and residual norms. Return the number of leading
+// eigenpairs out of k whose residuals are below the threshold.
+template<typename T, typename Mat, typename Vec, typename Precond>
+int block_eigs(const Eigen::SparseMatrix<T>& L,
+               int k,
+               unsigned max_iter,
+               T threshold,
+               const Precond& precondition,
+               Mat& X,
+               Vec& theta,
+               Vec& residuals)
+{
+    using RowSpMat = Eigen::SparseMatrix<T, Eigen::RowMajor>;
+
+    // L being symmetric, its column-major arrays are also its row-major ones,
+    // which Eigen multiplies with dense blocks in parallel
+    const auto nv = L.rows();
+    Eigen::Map<const RowSpMat> A(nv,
+                                 nv,
+                                 L.nonZeros(),
+                                 L.outerIndexPtr(),
+                                 L.innerIndexPtr(),
+                                 L.valuePtr());
+    const int m = static_cast<int>(X.cols());
+
+    orthonormalize(Mat(nv, 0), X);
+    Mat AX = A * X;
+    Mat coefs;
+    rayleigh_ritz(X, AX, m, coefs, theta);
+    X = X * coefs;
+    AX = AX * coefs;
+
+    Mat P(nv, 0);
+    int n = 0;
+    for (unsigned iter = 0;; ++iter) {
+        Mat R = AX - X * theta.asDiagonal();
+        residuals = R.colwise().norm().transpose();
+        const auto wanted = std::min<Eigen::Index>(k, X.cols());
+        n = 0;
+        while (n < wanted && residuals(n) <= threshold) {
+            ++n;
+        }
+        if (n == k || iter >= max_iter) {
+            break;
+        }
+
+        // Only the unconverged vectors get new search directions
+        std::vector<Eigen::Index> active;
+        for (Eigen::Index i = 0; i < X.cols(); ++i) {
+            if (residuals(i) > threshold) {
+                active.push_back(i);
+            }
+        }
+        Mat W(nv, active.size());
+        for (size_t i = 0; i < active.size(); ++i) {
+            W.col(i) = R.col(active[i]);
+        }
+        precondition(W);
+        orthonormalize(X, W);
+
+        // The search space [X, W, P] is kept orthonormal explicitly, as W and
+        // P become nearly dependent when the iteration converges
+        const auto nx = X.cols();
+        Mat S(nv, nx + W.cols());
+        S.leftCols(nx) = X;
+        S.rightCols(W.cols()) = W;
+        orthonormalize(S, P);
+        S.conservativeResize(Eigen::NoChange, S.cols() + P.cols());
+        S.rightCols(P.cols()) = P;
+        Mat AS(nv, S.cols());
+        AS.leftCols(nx) = AX;
+        AS.rightCols(S.cols() - nx) = A * S.rightCols(S.cols() - nx);
+        rayleigh_ritz(S, AS, m, coefs, theta);
+
+        // The next search directions are the updates from outside of X
+        P = S.rightCols(S.cols() - nx) * coefs.bottomRows(S.cols() - nx);
+        X = S * coefs;
+        AX = AS * coefs;
+    }
+    return n;
+}
+
+// Preconditioner applying an LDL^T factorization of a slightly shifted L,
+// since L itself is singular, so that the iteration behaves like a block
+// inverse iteration
+template<typename T>
+class ShiftedInverse
+{
+public:
+    explicit ShiftedInverse(const Eigen::SparseMatrix<T>& mat) : _solver(mat)
+    {
+        const T diag_max = mat.diagonal().cwiseAbs().maxCoeff();
+        const auto eps = std::numeric_limits<T>::epsilon();
+        _solver.set_shift(-diag_max * std::pow(eps, T(2) / 3));
+    }
+
+    template<typename Mat>
+    void operator()(Mat& block) const
+    {
+        Eigen::Matrix<T, Eigen::Dynamic, 1> x;
+        for (Eigen::Index i = 0; i < block.cols(); ++i) {
+            x = block.col(i);
+            _solver.perform_op(x.data(), block.col(i).data());
+        }
+    }
+
+private:
+    ParallelSymShiftSolve<T> _solver;
+};
+
+// The residual is measured against the Gershgorin bound of |L|
+template<typename T>
+T residual_threshold(const Eigen::SparseMatrix<T>& L, double tolerance)
+{
+    return static_cast<T>(tolerance) * 2 * L.diagonal().cwiseAbs().maxCoeff();
+}
+
+template<typename Mesh,
+         typename Vec,
+         typename DerivedA,
+         typename DerivedB,
+         typename DerivedC>
+unsigned lobpcg_solve(const OperatorRegistry<Mesh>& ops,
+                      const Vec& s,
+                      const Vec& d,
+                      const Eigen::MatrixBase<DerivedC>& initial,
+                      int k,
+                      int nv,
+                      unsigned max_iter,
+                      double tolerance,
+                      Eigen::MatrixBase<DerivedA>& lambdas,
+                      Eigen::MatrixBase<DerivedB>& phis)
+{
+    using T = typename Vec::Scalar;
+    using Mat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+    if (initial.cols() > 0 && initial.rows() != nv) {
+        throw std::invalid_argument(
+            "Initial eigenfunctions must have one row per vertex.");
+    }
+
+    // L = BSB as in the symmetric mode
+    Vec b = d.unaryExpr([](T v) { return v == 0 ? 0 : 1 / std::sqrt(v); });
+    Eigen::SparseMatrix<T> L = ops.matrix(ops.scale(s, b));
+
+    // The eigenfunctions are D-orthonormal, so their counterparts in the
+    // symmetric problem are D^{1/2} phi
+    const auto m = block_size(k, nv);
+    const auto c = static_cast<int>(std::min<Eigen::Index>(initial.cols(), m));
+    Mat X(nv, m);
+    if (c > 0) {
+        X.leftCols(c) = d.cwiseSqrt().asDiagonal() *
+                        initial.leftCols(c).template cast<T>();
+    }
+    X.rightCols(m - c).setRandom();
+
+    Vec theta, residuals;
+    auto n = block_eigs(L,
+                        k,
+                        max_iter,
+                        residual_threshold(L, tolerance),
+                        ShiftedInverse<T>(L),
+                        X,
+                        theta,
+                        residuals);
+    lambdas = theta.head(n);
+    phis = b.asDiagonal() * X.leftCols(n);
+    return static_cast<unsigned>(n);
+}
+
+// Greedy aggregation of the graph of a symmetric sparse matrix, a vertex and
+// its neighbors form an aggregate if none of them is taken yet, and the
+// leftovers then join an aggregate of their neighbors. Return the number of
+// aggregates.
+template<typename T>
+int aggregate(const Eigen::SparseMatrix<T>& mat, std::vector<int>& labels)
+{
+    using Iterator = typename Eigen::SparseMatrix<T>::InnerIterator;
+    const auto n = static_cast<int>(mat.cols());
+    labels.assign(n, -1);
+
+    int count = 0;
+    for (int i = 0; i < n; ++i) {
+        if (labels[i] != -1) {
+            continue;
+        }
+        bool free = true;
+        for (Iterator it(mat, i); it && free; ++it) {
+            free = labels[it.row()] == -1;
+        }
+        if (free) {
+            labels[i] = count;
+            for (Iterator it(mat, i); it; ++it) {
+                labels[it.row()] = count;
+            }
+            ++count;
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        if (labels[i] == -1) {
+            for (Iterator it(mat, i); it; ++it) {
+                if (labels[it.row()] != -1) {
+                    labels[i] = labels[it.row()];
+                    break;
+                }
+            }
+        }
+    }
+    return count;
+}
+
+// One level of the multilevel hierarchy, the generalized problem SX = lDX
+// with a diagonal D, and the aggregates of the finer level
+template<typename T>
+struct SpectralLevel
+{
+    Eigen::SparseMatrix<T> S;
+    Eigen::Matrix<T, Eigen::Dynamic, 1> d;
+    Eigen::SparseMatrix<T> prolongation;
+};
+
+template<typename Mesh,
+         typename Vec,
+         typename DerivedA,
+         typename DerivedB,
+         typename DerivedC>
+unsigned multilevel_solve(const OperatorRegistry<Mesh>& ops,
+                          const Vec& s,
+                          const Vec& d,
+                          int k,
+                          int nv,
+                          unsigned coarse_size,
+                          unsigned refinements,
+                          unsigned max_iter,
+                          double tolerance,
+                          Eigen::MatrixBase<DerivedA>& lambdas,
+                          Eigen::MatrixBase<DerivedB>& phis,
+                          Eigen::MatrixBase<DerivedC>& errors)
+{
+    using T = typename Vec::Scalar;
+    using Mat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+    using SpMat = Eigen::SparseMatrix<T>;
+    auto inv_sqrt = [](T v) { return v == 0 ? 0 : 1 / std::sqrt(v); };
+
+    // Coarsen by aggregation with piecewise constant prolongations, so that
+    // the Galerkin operators P^T S P are still Laplacians and the lumped
+    // masses P^T d are still diagonal, until the next level would be smaller
+    // than the coarse size
+    const auto m = block_size(k, nv);
+    const auto target = std::max<int>(coarse_size, 2 * m);
+    std::vector<SpectralLevel<T>> levels(1);
+    levels[0].S = ops.matrix(s);
+    levels[0].d = d;
+    std::vector<int> labels;
+    while (levels.back().S.rows() > target) {
+        const auto& fine = levels.back();
+        const auto n = static_cast<int>(fine.S.rows());
+        const auto nc = aggregate(fine.S, labels);
+        if (nc < target || nc > n * 4 / 5) {
+            break;
+        }
+        SpMat P(n, nc);
+        P.reserve(Eigen::VectorXi::Ones(n));
+        for (int i = 0; i < n; ++i) {
+            P.insert(i, labels[i]) = 1;
+        }
+        SpectralLevel<T> coarse;
+        coarse.S = P.transpose() * fine.S * P;
+        coarse.d = P.transpose() * fine.d;
+        coarse.prolongation = std::move(P);
+        levels.push_back(std::move(coarse));
+    }
+
+    // Solve the coarsest level to convergence
+    Vec b = levels.back().d.unaryExpr(inv_sqrt);
+    SpMat L = b.asDiagonal() * levels.back().S * b.asDiagonal();
+    Mat X(L.rows(), m);
+    X.setRandom();
+    Vec theta, residuals;
+    block_eigs(L,
+               k,
+               max_iter,
+               residual_threshold(L, tolerance),
+               ShiftedInverse<T>(L),
+               X,
+               theta,
+               residuals);
+
+    // Prolong the eigenfunctions level by level, and refine them by subspace
+    // iterations, each being a few damped Jacobi sweeps that smooth out the
+    // piecewise constant prolongation followed by a Rayleigh-Ritz projection
+    Mat AX, coefs;
+    for (auto i = levels.size() - 1; i > 0; --i) {
+        const auto& coarse = levels[i];
+        const auto& fine = levels[i - 1];
+        Mat phi = coarse.prolongation * (b.asDiagonal() * X);
+        b = fine.d.unaryExpr(inv_sqrt);
+        L = b.asDiagonal() * fine.S * b.asDiagonal();
+        X = fine.d.cwiseSqrt().asDiagonal() * phi;
+        Vec jacobi = L.diagonal().unaryExpr(
+            [](T v) { return v == 0 ? 0 : T(2) / 3 / v; });
+        for (unsigned r = 0; r < std::max(refinements, 1u); ++r) {
+            for (int sweep = 0; sweep < 5; ++sweep) {
+                AX = L * X;
+                X -= jacobi.asDiagonal() * AX;
+            }
+            orthonormalize(Mat(X.rows(), 0), X);
+            AX = L * X;
+            rayleigh_ritz(X, AX, m, coefs, theta);
+            X = X * coefs;
+        }
+        AX = AX * coefs;
+        residuals = (AX - X * theta.asDiagonal()).colwise().norm().transpose();
+    }
+
+    // The residual norm of a normalized Ritz vector bounds the distance from
+    // its Ritz value to the nearest exact eigenvalue
+    const auto n = std::min<Eigen::Index>(k, theta.size());
+    lambdas = theta.head(n);
+    phis = b.asDiagonal() * X.leftCols(n);
+    errors = residuals.head(n);
+    return static_cast<unsigned>(n);
+}
+
+// Inverse of a symmetric matrix restricted to the orthogonal complement of a
+// set of orthonormal vectors, the vectors themselves are mapped to zero
+template<typename T>
+class DeflatedSymInverse
+{
+public:
+    using Mat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+    using Vec = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+
+    DeflatedSymInverse(const Eigen::SparseMatrix<T>& mat, const Mat& basis)
+        : _basis(basis), _solver(mat)
+    {
+        _solver.set_shift(0);
+    }
+
+    int rows() const
+    {
+        return static_cast<int>(_basis.rows());
+    }
+
+    int cols() const
+    {
+        return rows();
+    }
+
+    void perform_op(const T* x_in, T* y_out)
+    {
+        Eigen::Map<const Vec> x(x_in, rows());
+        Eigen::Map<Vec> y(y_out, rows());
+        Vec px = x - _basis * (_basis.transpose() * x);
+        Vec z(rows());
+        _solver.perform_op(px.data(), z.data());
+        y = z - _basis * (_basis.transpose() * z);
+    }
+
+private:
+    const Mat& _basis;
+    ParallelSymShiftSolve<T> _solver;
+};
+
+// Extend a known part of the spectrum, i.e. the first m eigenpairs, to k
+// eigenpairs. The problem is solved in its symmetric form for both
+// decompositions, the known eigenvectors are deflated from the shift-invert
+// operator so that only the missing ones are computed.
+template<typename Mesh,
+         typename Vec,
+         typename DerivedL,
+         typename DerivedP,
+         typename DerivedA,
+         typename DerivedB>
+unsigned extend_solve(const OperatorRegistry<Mesh>& ops,
+                      const Vec& s,
+                      const Vec& d,
+                      const Eigen::MatrixBase<DerivedL>& known_lambdas,
+                      const Eigen::MatrixBase<DerivedP>& known_phis,
+                      int k,
+                      int nv,
+                      unsigned max_iter,
+                      double tolerance,
+                      Eigen::MatrixBase<DerivedA>& lambdas,
+                      Eigen::MatrixBase<DerivedB>& phis)
+{
+    using T = typename Vec::Scalar;
+    using Mat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+
+    const int m = static_cast<int>(known_lambdas.size());
+    Vec b = d.unaryExpr([](T v) { return v == 0 ? 0 : 1 / std::sqrt(v); });
+    Eigen::SparseMatrix<T> L = ops.matrix(ops.scale(s, b));
+
+    // Orthonormal basis of the known eigenvectors of L
+    Mat known = d.cwiseSqrt().asDiagonal() * known_phis;
+    Eigen::HouseholderQR<Mat> qr(known);
+    Mat basis = qr.householderQ() * Mat::Identity(nv, m);
+
+    const int nev = k - m;
+    const int convergence = std::min(2 * nev + 1, nv - m);
+    DeflatedSymInverse<T> op(L, basis);
+    Spectra::SymEigsSolver<T, Spectra::LARGEST_ALGE, DeflatedSymInverse<T>>
+        eigensolver(&op, nev, convergence);
+    eigensolver.init();
+    unsigned n = eigensolver.compute(
+        max_iter, static_cast<T>(tolerance), Spectra::LARGEST_ALGE);
+    if (eigensolver.info() != Spectra::SUCCESSFUL) {
+        throw std::runtime_error(
+            "Unable to compute eigen values of the Laplacian matrix.");
+    }
+
+    // The largest eigenvalues of the inverse are the smallest ones of L
+    Vec mu = eigensolver.eigenvalues();
+    Mat vecs = b.asDiagonal() * eigensolver.eigenvectors();
+    lambdas.derived().resize(m + n, 1);
+    phis.derived().resize(nv, m + n);
+    lambdas.head(m) = known_lambdas;
+    phis.leftCols(m) = known_phis;
+    lambdas.tail(n) = mu.cwiseInverse();
+    phis.rightCols(n) = vecs;
+    return m + n;
+}
+
+inline unsigned clamp_spectrum(unsigned k, size_t nv)
+{
+    if (k > nv) {
+        std::string err("You've requested ");
+        err.append(std::to_string(k));
+        err.append(" eigen values but there are only ");
+        err.append(std::to_string(nv));
+        err.append(" vertices in your mesh.");
+        EWARNING(err);
+        k = static_cast<unsigned>(nv);
+    }
+    return k;
+}
+
+inline void check_converged(unsigned k, unsigned n)
+{
+    if (n < k) {
+        auto str = std::to_string(k);
+        str.append(" eigen values are requested, but only ");
+        str.append(std::to_string(n));
+        str.append(" values converged in computation.");
+        EWARNING(str);
+    }
+}
+
 } // namespace _impl
 
 template<typename Mesh, typename DerivedA, typename DerivedB>
@@ -113,37 +642,121 @@ unsigned spectrum(const Mesh& mesh,
     using T = typename CGAL::Kernel_traits<typename boost::property_traits<
         typename boost::property_map<Mesh, boost::vertex_point_t>::type>::
                                                value_type>::Kernel::FT;
-    using SpMat = Eigen::SparseMatrix<T>;
+    using Vec = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    using Mat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
     auto nv = num_vertices(mesh);
 
-    if (k > nv) {
-        std::string err("You've requested ");
-        err.append(std::to_string(k));
-        err.append(" eigen values but there are only ");
-        err.append(std::to_string(nv));
-        err.append(" vertices in your mesh.");
-        EWARNING(err);
-        k = nv;
+    if (decomp == SpecDecomp::lobpcg) {
+        return spectrum(
+            mesh, k, lambdas, phis, Mat(), op, max_iter, tolerance);
+    }
+    if (decomp == SpecDecomp::multilevel) {
+        Vec errors;
+        return multilevel_spectrum(mesh,
+                                   k,
+                                   lambdas,
+                                   phis,
+                                   errors,
+                                   op,
+                                   5000,
+                                   2,
+                                   max_iter,
+                                   tolerance);
     }
+    k = _impl::clamp_spectrum(k, nv);
 
-    SpMat S, D;
-    _impl::get_mat(mesh, op, S, D);
+    OperatorRegistry<Mesh> ops;
+    ops.build(mesh);
+    Vec s, d;
+    _impl::get_mat(ops, op, s, d);
 
     unsigned n;
     if (decomp == SpecDecomp::symmetric) {
-        n = _impl::sym_solve(S, D, k, nv, max_iter, tolerance, lambdas, phis);
+        n = _impl::sym_solve(
+            ops, s, d, k, nv, max_iter, tolerance, lambdas, phis);
     }
     else {
-        n = _impl::gen_solve(S, D, k, nv, max_iter, tolerance, lambdas, phis);
-    }
-    if (n < k) {
-        auto str = std::to_string(k);
-        str.append(" eigen values are requested, but only ");
-        str.append(std::to_string(n));
-        str.append(" values converged in computation.");
-        EWARNING(str);
+        n = _impl::gen_solve(
+            ops, s, d, k, nv, max_iter, tolerance, lambdas, phis);
     }
+    _impl::check_converged(k, n);
+    EASSERT(lambdas.rows() == n);
+    EASSERT(phis.cols() == n);
+    EASSERT(phis.rows() == nv);
+
+    return n;
+}
+
+template<typename Mesh, typename DerivedA, typename DerivedB, typename DerivedC>
+unsigned spectrum(const Mesh& mesh,
+                  unsigned k,
+                  Eigen::MatrixBase<DerivedA>& lambdas,
+                  Eigen::MatrixBase<DerivedB>& phis,
+                  const Eigen::MatrixBase<DerivedC>& initial,
+                  SpecOp op,
+                  unsigned max_iter,
+                  double tolerance)
+{
+    using T = typename CGAL::Kernel_traits<typename boost::property_traits<
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type>::
+                                               value_type>::Kernel::FT;
+    using Vec = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    auto nv = num_vertices(mesh);
+    k = _impl::clamp_spectrum(k, nv);
+
+    OperatorRegistry<Mesh> ops;
+    ops.build(mesh);
+    Vec s, d;
+    _impl::get_mat(ops, op, s, d);
+
+    unsigned n = _impl::lobpcg_solve(
+        ops, s, d, initial, k, nv, max_iter, tolerance, lambdas, phis);
+    _impl::check_converged(k, n);
+    EASSERT(lambdas.rows() == n);
+    EASSERT(phis.cols() == n);
+    EASSERT(phis.rows() == nv);
+
+    return n;
+}
+
+template<typename Mesh, typename DerivedA, typename DerivedB, typename DerivedC>
+unsigned multilevel_spectrum(const Mesh& mesh,
+                             unsigned k,
+                             Eigen::MatrixBase<DerivedA>& lambdas,
+                             Eigen::MatrixBase<DerivedB>& phis,
+                             Eigen::MatrixBase<DerivedC>& errors,
+                             SpecOp op,
+                             unsigned coarse_size,
+                             unsigned refinements,
+                             unsigned max_iter,
+                             double tolerance)
+{
+    using T = typename CGAL::Kernel_traits<typename boost::property_traits<
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type>::
+                                               value_type>::Kernel::FT;
+    using Vec = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    auto nv = num_vertices(mesh);
+    k = _impl::clamp_spectrum(k, nv);
+
+    OperatorRegistry<Mesh> ops;
+    ops.build(mesh);
+    Vec s, d;
+    _impl::get_mat(ops, op, s, d);
+
+    unsigned n = _impl::multilevel_solve(ops,
+                                         s,
+                                         d,
+                                         k,
+                                         nv,
+                                         coarse_size,
+                                         refinements,
+                                         max_iter,
+                                         tolerance,
+                                         lambdas,
+                                         phis,
+                                         errors);
     EASSERT(lambdas.rows() == n);
+    EASSERT(errors.rows() == n);
     EASSERT(phis.cols() == n);
     EASSERT(phis.rows() == nv);
 
@@ -0,0 +1,246 @@
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+#include <CGAL/boost/graph/properties.h>
+#include <Euclid/Geometry/OperatorRegistry.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+#include <Euclid/Util/Assert.h>
+#include <Euclid/Util/Serialize.h>
+
+namespace Euclid
+{
+
+namespace _impl
+{
+
+// 64-bit FNV-1a, stable across platforms and runs
+inline uint64_t fnv1a(const void* data,
+                      size_t size,
+                      uint64_t seed = 14695981039346656037ull)
+{
+    auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        seed ^= bytes[i];
+        seed *= 1099511628211ull;
+    }
+    return seed;
+}
+
+} // namespace _impl
+
+template<typename T>
+MappedSpectrum<T>::MappedSpectrum(const std::string& filename)
+    : _file(filename.c_str(), boost::interprocess::read_only),
+      _region(_file, boost::interprocess::read_only)
+{
+    // Layout written by serialize(hash, eigenvalues, eigenfunctions)
+    auto data = static_cast<const char*>(_region.get_address());
+    const auto size = _region.get_size();
+    const auto header = sizeof(uint64_t) + 2 * sizeof(Eigen::Index);
+    auto corrupted = [&filename]() {
+        std::string err("Corrupted spectrum cache file ");
+        err.append(filename);
+        return std::runtime_error(err);
+    };
+
+    if (size < header) {
+        throw corrupted();
+    }
+    Eigen::Index rows, cols;
+    std::copy_n(data, sizeof(uint64_t), reinterpret_cast<char*>(&_hash));
+    data += sizeof(uint64_t);
+    std::copy_n(data, sizeof(rows), reinterpret_cast<char*>(&rows));
+    data += sizeof(rows);
+    std::copy_n(data, sizeof(cols), reinterpret_cast<char*>(&cols));
+    data += sizeof(cols);
+    _k = rows;
+    if (cols != 1 || size < header + _k * sizeof(T) + 2 * sizeof(cols)) {
+        throw corrupted();
+    }
+    _lambdas = reinterpret_cast<const T*>(data);
+    data += _k * sizeof(T);
+
+    std::copy_n(data, sizeof(rows), reinterpret_cast<char*>(&rows));
+    data += sizeof(rows);
+    std::copy_n(data, sizeof(cols), reinterpret_cast<char*>(&cols));
+    data += sizeof(cols);
+    _nv = rows;
+    const auto expected = header + 2 * sizeof(cols) + _k * sizeof(T) +
+                          _nv * cols * sizeof(T);
+    if (cols != _k || size != expected) {
+        throw corrupted();
+    }
+    _phis = reinterpret_cast<const T*>(data);
+}
+
+template<typename T>
+uint64_t MappedSpectrum<T>::hash() const
+{
+    return _hash;
+}
+
+template<typename T>
+unsigned MappedSpectrum<T>::size() const
+{
+    return static_cast<unsigned>(_k);
+}
+
+template<typename T>
+Eigen::Map<const typename MappedSpectrum<T>::Vec>
+MappedSpectrum<T>::eigenvalues() const
+{
+    return Eigen::Map<const Vec>(_lambdas, _k);
+}
+
+template<typename T>
+Eigen::Map<const typename MappedSpectrum<T>::Mat>
+MappedSpectrum<T>::eigenfunctions() const
+{
+    return Eigen::Map<const Mat>(_phis, _nv, _k);
+}
+
+inline SpectrumCache::SpectrumCache(const std::string& directory)
+    : _directory(directory)
+{
+    if (!_directory.empty() && _directory.back() != '/') {
+        _directory.push_back('/');
+    }
+}
+
+template<typename Mesh>
+uint64_t SpectrumCache::hash(const Mesh& mesh,
+                             SpecOp op,
+                             SpecDecomp decomp) const
+{
+    using T = typename CGAL::Kernel_traits<typename boost::property_traits<
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type>::
+                                               value_type>::Kernel::FT;
+
+    std::vector<T> positions;
+    std::vector<uint64_t> indices;
+    extract_mesh<3>(mesh, positions, indices);
+    const int32_t keys[] = {static_cast<int32_t>(sizeof(T)),
+                            static_cast<int32_t>(op),
+                            static_cast<int32_t>(decomp)};
+
+    auto seed = _impl::fnv1a(keys, sizeof(keys));
+    seed = _impl::fnv1a(positions.data(), positions.size() * sizeof(T), seed);
+    seed = _impl::fnv1a(
+        indices.data(), indices.size() * sizeof(uint64_t), seed);
+    return seed;
+}
+
+template<typename Mesh>
+std::string SpectrumCache::path(const Mesh& mesh,
+                                SpecOp op,
+                                SpecDecomp decomp) const
+{
+    return _filename(hash(mesh, op, decomp));
+}
+
+inline std::string SpectrumCache::_filename(uint64_t key) const
+{
+    std::ostringstream ss;
+    ss << _directory << std::hex << std::setw(16) << std::setfill('0') << key
+       << ".spectrum";
+    return ss.str();
+}
+
+template<typename Mesh, typename DerivedA, typename DerivedB>
+unsigned SpectrumCache::spectrum(const Mesh& mesh,
+                                 unsigned k,
+                                 Eigen::MatrixBase<DerivedA>& lambdas,
+                                 Eigen::MatrixBase<DerivedB>& phis,
+                                 SpecOp op,
+                                 SpecDecomp decomp,
+                                 unsigned max_iter,
+                                 double tolerance) const
+{
+    using T = typename CGAL::Kernel_traits<typename boost::property_traits<
+        typename boost::property_map<Mesh, boost::vertex_point_t>::type>::
+                                               value_type>::Kernel::FT;
+    using Vec = Eigen::Matrix<T, Eigen::Dynamic, 1>;
+    using Mat = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>;
+    const auto nv = static_cast<int>(num_vertices(mesh));
+    k = std::min(k, static_cast<unsigned>(nv));
+
+    const auto key = hash(mesh, op, decomp);
+    const auto filename = _filename(key);
+
+    Vec new_lambdas;
+    Mat new_phis;
+    unsigned n = 0;
+    if (std::ifstream(filename).good()) {
+        std::unique_ptr<MappedSpectrum<T>> cached;
+        try {
+            cached = std::make_unique<MappedSpectrum<T>>(filename);
+        }
+        catch (const std::exception&) {
+            EWARNING("Corrupted spectrum cache, the entry is overwritten.");
+        }
+        if (cached && cached->hash() == key &&
+            cached->eigenfunctions().rows() == nv) {
+            if (cached->size() >= k) {
+                lambdas = cached->eigenvalues().head(k);
+                phis = cached->eigenfunctions().leftCols(k);
+                return k;
+            }
+            if (cached->size() > 0) {
+                OperatorRegistry<Mesh> ops;
+                ops.build(mesh);
+                Vec s, d;
+                _impl::get_mat(ops, op, s, d);
+                n = _impl::extend_solve(ops,
+                                        s,
+                                        d,
+                                        cached->eigenvalues(),
+                                        cached->eigenfunctions(),
+                                        k,
+                                        nv,
+                                        max_iter,
+                                        tolerance,
+                                        new_lambdas,
+                                        new_phis);
+            }
+        }
+        else if (cached) {
+            EWARNING("Spectrum cache collision, the entry is overwritten.");
+        }
+    }
+    if (n == 0) {
+        n = Euclid::spectrum(mesh,
+                             k,
+                             new_lambdas,
+                             new_phis,
+                             op,
+                             decomp,
+                             max_iter,
+                             tolerance);
+    }
+
+    // Write to a temporary file first so that readers never see partial data,
+    // the name is unique so that concurrent writers don't share it
+    auto temporary = filename;
+    temporary.append(".");
+    temporary.append(boost::filesystem::unique_path().string());
+    temporary.append(".tmp");
+    serialize(temporary, key, new_lambdas, new_phis);
+    boost::system::error_code ec;
+    boost::filesystem::rename(temporary, filename, ec);
+    if (ec) {
+        boost::filesystem::remove(temporary, ec);
+        EWARNING("Unable to update the spectrum cache.");
+    }
+
+    lambdas = new_lambdas;
+    phis = new_phis;
+    return n;
+}
+
+} // namespace Euclid
@@ -1,18 +1,150 @@
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
-#include <boost/functional/hash.hpp>
 #include <boost/math/constants/constants.hpp>
 #include <CGAL/boost/graph/helpers.h>
+#include <Eigen/Geometry>
+#include <Euclid/Geometry/TriMeshKernels.h>
 #include <Euclid/Math/Vector.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
 #include <Euclid/Util/Assert.h>
 
 namespace Euclid
 {
 
+namespace _impl
+{
+
+// Batched curvature computation on raw triangle arrays
+template<typename T, typename IT>
+Curvatures<T> curvatures(const std::vector<T>& positions,
+                         const std::vector<IT>& indices,
+                         bool directions)
+{
+    using Vec3 = Eigen::Matrix<T, 3, 1>;
+    using Mat3 = Eigen::Matrix<T, 3, 3>;
+    const auto nv = positions.size() / 3;
+    const auto nf = indices.size() / 3;
+
+    // Evaluate the per-face and per-corner quantities only once
+    std::vector<T> fnormals(3 * nf);
+    std::vector<T> fareas(nf);
+    std::vector<T> cotangents(3 * nf);
+    std::vector<T> angles(3 * nf);
+    std::vector<T> cells(3 * nf);
+    for_each_face_block(
+        positions, indices, [&](const auto& block, size_t first, int n) {
+            BlockArray<T> rcp =
+                (block.norm > 0).select(block.norm.inverse(), 0);
+            BlockArray<T> nx = block.nx * rcp;
+            BlockArray<T> ny = block.ny * rcp;
+            BlockArray<T> nz = block.nz * rcp;
+            Eigen::Map<BlockArray<T>>(fareas.data() + first, n) =
+                block.norm * static_cast<T>(0.5);
+            for (int i = 0; i < n; ++i) {
+                fnormals[3 * (first + i) + 0] = nx(i);
+                fnormals[3 * (first + i) + 1] = ny(i);
+                fnormals[3 * (first + i) + 2] = nz(i);
+            }
+            for (int c = 0; c < 3; ++c) {
+                BlockArray<T> cot = block.cotangent(c);
+                BlockArray<T> angle = block.angle(c);
+                BlockArray<T> cell = block.mixed_voronoi_area(c);
+                for (int i = 0; i < n; ++i) {
+                    cotangents[3 * (first + i) + c] = cot(i);
+                    angles[3 * (first + i) + c] = angle(i);
+                    cells[3 * (first + i) + c] = cell(i);
+                }
+            }
+        });
+
+    // Gather them around every vertex
+    std::vector<size_t> offsets, corners;
+    vertex_corners(nv, indices, offsets, corners);
+
+    Curvatures<T> result;
+    result.mean.setZero(nv);
+    result.gaussian.setZero(nv);
+    result.k_max.setZero(nv);
+    result.k_min.setZero(nv);
+    if (directions) {
+        result.d_max.setZero(nv, 3);
+        result.d_min.setZero(nv, 3);
+    }
+    const auto two_pi = boost::math::constants::two_pi<T>();
+
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < static_cast<int>(nv); ++i) {
+        Vec3 pi = Vec3::Map(&positions[3 * i]);
+        Vec3 laplacian = Vec3::Zero();
+        Vec3 normal = Vec3::Zero();
+        T area = 0;
+        T defect = two_pi;
+        for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+            const auto corner = corners[k];
+            const auto f = corner / 3;
+            const auto cj = 3 * f + (corner + 1) % 3;
+            const auto ck = 3 * f + (corner + 2) % 3;
+            Vec3 pj = Vec3::Map(&positions[3 * indices[cj]]);
+            Vec3 pk = Vec3::Map(&positions[3 * indices[ck]]);
+            laplacian +=
+                cotangents[ck] * (pi - pj) + cotangents[cj] * (pi - pk);
+            normal += fareas[f] * Vec3::Map(&fnormals[3 * f]);
+            area += cells[corner];
+            defect -= angles[corner];
+        }
+        if (area <= 0 || normal.squaredNorm() == 0) { continue; }
+        normal.normalize();
+
+        auto h = laplacian.norm() / (4 * area);
+        if (laplacian.dot(normal) < 0) { h = -h; }
+        auto kg = defect / area;
+        auto delta = std::sqrt(std::max(h * h - kg, static_cast<T>(0)));
+        result.mean(i) = h;
+        result.gaussian(i) = kg;
+        result.k_max(i) = h + delta;
+        result.k_min(i) = h - delta;
+        if (!directions) { continue; }
+
+        // Curvature tensor from the normal curvatures along the edges
+        Mat3 tensor = Mat3::Zero();
+        T weight = 0;
+        for (auto k = offsets[i]; k < offsets[i + 1]; ++k) {
+            const auto corner = corners[k];
+            const auto f = corner / 3;
+            for (auto cj : { 3 * f + (corner + 1) % 3,
+                             3 * f + (corner + 2) % 3 }) {
+                Vec3 e = Vec3::Map(&positions[3 * indices[cj]]) - pi;
+                Vec3 t = e - normal.dot(e) * normal;
+                if (t.squaredNorm() == 0) { continue; }
+                auto kappa = -2 * normal.dot(e) / e.squaredNorm();
+                t.normalize();
+                tensor += fareas[f] * kappa * t * t.transpose();
+                weight += fareas[f];
+            }
+        }
+        if (weight <= 0) { continue; }
+        tensor /= weight;
+
+        // Its eigenvectors in the tangent plane are the principal directions
+        Vec3 u = normal.unitOrthogonal();
+        Vec3 v = normal.cross(u);
+        auto a = u.dot(tensor * u);
+        auto b = u.dot(tensor * v);
+        auto c = v.dot(tensor * v);
+        auto theta = static_cast<T>(0.5) * std::atan2(2 * b, a - c);
+        Vec3 d_max = std::cos(theta) * u + std::sin(theta) * v;
+        result.d_max.row(i) = d_max.transpose();
+        result.d_min.row(i) = normal.cross(d_max).transpose();
+    }
+    return result;
+}
+
+} // namespace _impl
+
 template<typename Mesh, typename Vector_3>
 Vector_3 vertex_normal(
     typename boost::graph_traits<const Mesh>::vertex_descriptor v,
@@ -346,6 +478,23 @@ std::vector<T> gaussian_curvatures(const Mesh& mesh)
     return curvatures;
 }
 
+template<typename Mesh, typename T>
+std::vector<T> mean_curvatures(const Mesh& mesh)
+{
+    auto curvatures = principal_curvatures<Mesh, T>(mesh, false);
+    return std::vector<T>(curvatures.mean.data(),
+                          curvatures.mean.data() + curvatures.mean.size());
+}
+
+template<typename Mesh, typename T>
+Curvatures<T> principal_curvatures(const Mesh& mesh, bool directions)
+{
+    std::vector<T> positions;
+    std::vector<size_t> indices;
+    extract_mesh<3>(mesh, positions, indices);
+    return _impl::curvatures(positions, indices, directions);
+}
+
 template<typename Mesh, typename T>
 std::tuple<Eigen::SparseMatrix<T>, Eigen::SparseMatrix<T>> adjacency_matrix(
     const Mesh& mesh)
@@ -378,48 +527,19 @@ std::tuple<Eigen::SparseMatrix<T>, Eigen::SparseMatrix<T>> adjacency_matrix(
 template<typename Mesh, typename T>
 Eigen::SparseMatrix<T> cotangent_matrix(const Mesh& mesh)
 {
-    using Triplet = Eigen::Triplet<T>;
-    auto vpmap = get(boost::vertex_point, mesh);
-    auto vimap = get(boost::vertex_index, mesh);
     const auto nv = num_vertices(mesh);
+    std::vector<T> positions;
+    std::vector<int> indices;
+    std::vector<T> cotangents;
+    extract_mesh<3>(mesh, positions, indices);
+    cotangent_weights(positions, indices, cotangents);
 
-    auto hash_fcn = [](const Triplet& t) {
-        size_t seed = 0;
-        boost::hash_combine(seed, t.col());
-        boost::hash_combine(seed, t.row());
-        return seed;
-    };
-    auto eq_fcn = [](const Triplet& t1, const Triplet& t2) {
-        return (t1.col() == t2.col()) && (t1.row() == t2.row());
-    };
-    std::unordered_set<Triplet, decltype(hash_fcn), decltype(eq_fcn)> values(
-        nv, hash_fcn, eq_fcn);
-
-    for (auto vi : vertices(mesh)) {
-        int i = get(vimap, vi);
-        T row_sum = 0.0;
-        for (auto he : halfedges_around_target(vi, mesh)) {
-            auto vj = source(he, mesh);
-            int j = get(vimap, vj);
-            auto existing = values.find(Triplet(j, i, 0.0));
-            if (existing != values.end()) {
-                values.emplace(i, j, existing->value());
-                row_sum -= existing->value();
-            }
-            else {
-                auto va = target(next(he, mesh), mesh);
-                auto vb = target(next(opposite(he, mesh), mesh), mesh);
-                auto cota =
-                    cotangent(get(vpmap, vi), get(vpmap, va), get(vpmap, vj));
-                auto cotb =
-                    cotangent(get(vpmap, vi), get(vpmap, vb), get(vpmap, vj));
-                auto value = static_cast<T>((cota + cotb) * 0.5);
-                values.emplace(i, j, -value);
-                row_sum += value;
-            }
-        }
-        values.emplace(i, i, row_sum);
-    }
+    std::vector<Eigen::Triplet<T>> values;
+    values.reserve(4 * indices.size());
+    _impl::scatter_cotangent_laplacian(
+        indices, cotangents, [&](int i, int j, T value) {
+            values.emplace_back(i, j, value);
+        });
 
     Eigen::SparseMatrix<T> mat(nv, nv);
     mat.setFromTriplets(values.begin(), values.end());
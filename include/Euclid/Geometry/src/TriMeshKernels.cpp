@@ -0,0 +1,288 @@
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/math/constants/constants.hpp>
+#include <Eigen/Core>
+
+namespace Euclid
+{
+
+namespace _impl
+{
+
+constexpr int face_block_size = 256;
+
+template<typename FT>
+using BlockArray = Eigen::
+    Array<FT, Eigen::Dynamic, 1, Eigen::ColMajor, face_block_size, 1>;
+
+// A block of faces in structure-of-arrays form
+template<typename FT>
+struct FaceBlock
+{
+    // Edge opposite to corner c, i.e. p[c + 2] - p[c + 1]
+    BlockArray<FT> ex[3];
+    BlockArray<FT> ey[3];
+    BlockArray<FT> ez[3];
+
+    // Unnormalized face normal and its length, i.e. twice the face area
+    BlockArray<FT> nx;
+    BlockArray<FT> ny;
+    BlockArray<FT> nz;
+    BlockArray<FT> norm;
+
+    template<typename IT>
+    void load(const std::vector<FT>& positions,
+              const std::vector<IT>& indices,
+              size_t first,
+              int n)
+    {
+        // Gather the corner positions, then take the differences as arrays
+        BlockArray<FT> px[3], py[3], pz[3];
+        for (int c = 0; c < 3; ++c) {
+            px[c].resize(n);
+            py[c].resize(n);
+            pz[c].resize(n);
+        }
+        for (int i = 0; i < n; ++i) {
+            const auto f = 3 * (first + i);
+            for (int c = 0; c < 3; ++c) {
+                const auto p = 3 * static_cast<size_t>(indices[f + c]);
+                px[c](i) = positions[p + 0];
+                py[c](i) = positions[p + 1];
+                pz[c](i) = positions[p + 2];
+            }
+        }
+        for (int c = 0; c < 3; ++c) {
+            const auto a = (c + 1) % 3;
+            const auto b = (c + 2) % 3;
+            ex[c] = px[b] - px[a];
+            ey[c] = py[b] - py[a];
+            ez[c] = pz[b] - pz[a];
+        }
+        nx = ey[1] * ez[2] - ez[1] * ey[2];
+        ny = ez[1] * ex[2] - ex[1] * ez[2];
+        nz = ex[1] * ey[2] - ey[1] * ex[2];
+        norm = (nx.square() + ny.square() + nz.square()).sqrt();
+    }
+
+    // Cotangent of the interior angle at corner c
+    BlockArray<FT> cotangent(int c) const
+    {
+        const auto a = (c + 1) % 3;
+        const auto b = (c + 2) % 3;
+        return -(ex[a] * ex[b] + ey[a] * ey[b] + ez[a] * ez[b]) / norm;
+    }
+
+    // Interior angle at corner c, atan2(|n|, dot) for a positive |n|
+    BlockArray<FT> angle(int c) const
+    {
+        const auto half_pi = boost::math::constants::half_pi<FT>();
+        return half_pi - cotangent(c).atan();
+    }
+
+    // Squared length of the edge opposite to corner c
+    BlockArray<FT> squared_length(int c) const
+    {
+        return ex[c].square() + ey[c].square() + ez[c].square();
+    }
+
+    // Portion of the mixed voronoi cell of corner c inside the face
+    BlockArray<FT> mixed_voronoi_area(int c) const
+    {
+        const auto a = (c + 1) % 3;
+        const auto b = (c + 2) % 3;
+        BlockArray<FT> cot_c = cotangent(c);
+        BlockArray<FT> cot_a = cotangent(a);
+        BlockArray<FT> cot_b = cotangent(b);
+        BlockArray<FT> area = norm * static_cast<FT>(0.5);
+        BlockArray<FT> voronoi =
+            (squared_length(a) * cot_a + squared_length(b) * cot_b) *
+            static_cast<FT>(0.125);
+        return (cot_c < 0).select(
+            area * static_cast<FT>(0.5),
+            (cot_a < 0 || cot_b < 0)
+                .select(area * static_cast<FT>(0.25), voronoi));
+    }
+};
+
+template<typename FT, typename IT>
+void check_buffers(const std::vector<FT>& positions,
+                   const std::vector<IT>& indices)
+{
+    if (positions.size() % 3 != 0) {
+        throw std::runtime_error("Input positions size is not divisible by 3");
+    }
+    if (indices.size() % 3 != 0) {
+        throw std::runtime_error("Input indices size is not divisible by 3");
+    }
+}
+
+// Call fn(block, first, n) on consecutive blocks of faces, in parallel
+template<typename FT, typename IT, typename Fn>
+void for_each_face_block(const std::vector<FT>& positions,
+                         const std::vector<IT>& indices,
+                         Fn fn)
+{
+    const auto nf = indices.size() / 3;
+    const auto nblocks =
+        static_cast<int>((nf + face_block_size - 1) / face_block_size);
+
+#pragma omp parallel for schedule(static)
+    for (int b = 0; b < nblocks; ++b) {
+        const auto first = static_cast<size_t>(b) * face_block_size;
+        const auto n = static_cast<int>(
+            std::min<size_t>(face_block_size, nf - first));
+        FaceBlock<FT> block;
+        block.load(positions, indices, first, n);
+        fn(block, first, n);
+    }
+}
+
+// Build the vertex to corner incidence in compressed form, corners of vertex
+// i are corners[offsets[i]] to corners[offsets[i + 1] - 1], where corner c is
+// the (c % 3)-th vertex of face (c / 3)
+template<typename IT>
+void vertex_corners(size_t nv,
+                    const std::vector<IT>& indices,
+                    std::vector<size_t>& offsets,
+                    std::vector<size_t>& corners)
+{
+    offsets.assign(nv + 1, 0);
+    for (auto i : indices) {
+        ++offsets[static_cast<size_t>(i) + 1];
+    }
+    for (size_t i = 0; i < nv; ++i) {
+        offsets[i + 1] += offsets[i];
+    }
+    std::vector<size_t> slots(offsets.begin(), offsets.end() - 1);
+    corners.resize(indices.size());
+    for (size_t c = 0; c < indices.size(); ++c) {
+        corners[slots[indices[c]]++] = c;
+    }
+}
+
+// Scatter the cotangent Laplacian of faces [first, first + n), whose corners
+// have the cotangents cotangent(f, c). Each corner calls add(i, j, value) on
+// both directions of its opposite edge with minus half its cotangent, and on
+// both ends of the edge with the opposite, to be summed over all faces. So an
+// interior edge gets the cotangents of both faces, a border edge only the one
+// of its single face, and each diagonal entry is the row sum.
+template<typename IT, typename Cotangent, typename Add>
+void scatter_cotangent_laplacian(const std::vector<IT>& indices,
+                                 size_t first,
+                                 size_t n,
+                                 Cotangent cotangent,
+                                 Add add)
+{
+    for (auto f = first; f < first + n; ++f) {
+        for (int c = 0; c < 3; ++c) {
+            const auto a = indices[3 * f + (c + 1) % 3];
+            const auto b = indices[3 * f + (c + 2) % 3];
+            const auto w = cotangent(f, c) / 2;
+            add(a, b, -w);
+            add(b, a, -w);
+            add(a, a, w);
+            add(b, b, w);
+        }
+    }
+}
+
+// Scatter the cotangent Laplacian of all faces from the per-corner cotangents
+// computed by cotangent_weights()
+template<typename FT, typename IT, typename Add>
+void scatter_cotangent_laplacian(const std::vector<IT>& indices,
+                                 const std::vector<FT>& cotangents,
+                                 Add add)
+{
+    scatter_cotangent_laplacian(
+        indices,
+        0,
+        indices.size() / 3,
+        [&](size_t f, int c) { return cotangents[3 * f + c]; },
+        add);
+}
+
+} // namespace _impl
+
+template<typename FT, typename IT>
+void face_normals(const std::vector<FT>& positions,
+                  const std::vector<IT>& indices,
+                  std::vector<FT>& normals)
+{
+    _impl::check_buffers(positions, indices);
+    normals.resize(indices.size());
+    _impl::for_each_face_block(
+        positions, indices, [&](const auto& block, size_t first, int n) {
+            _impl::BlockArray<FT> rcp =
+                (block.norm > 0).select(block.norm.inverse(), 0);
+            _impl::BlockArray<FT> x = block.nx * rcp;
+            _impl::BlockArray<FT> y = block.ny * rcp;
+            _impl::BlockArray<FT> z = block.nz * rcp;
+            for (int i = 0; i < n; ++i) {
+                normals[3 * (first + i) + 0] = x(i);
+                normals[3 * (first + i) + 1] = y(i);
+                normals[3 * (first + i) + 2] = z(i);
+            }
+        });
+}
+
+template<typename FT, typename IT>
+void face_areas(const std::vector<FT>& positions,
+                const std::vector<IT>& indices,
+                std::vector<FT>& areas)
+{
+    _impl::check_buffers(positions, indices);
+    areas.resize(indices.size() / 3);
+    _impl::for_each_face_block(
+        positions, indices, [&](const auto& block, size_t first, int n) {
+            Eigen::Map<_impl::BlockArray<FT>>(areas.data() + first, n) =
+                block.norm * static_cast<FT>(0.5);
+        });
+}
+
+template<typename FT, typename IT>
+void cotangent_weights(const std::vector<FT>& positions,
+                       const std::vector<IT>& indices,
+                       std::vector<FT>& cotangents)
+{
+    _impl::check_buffers(positions, indices);
+    cotangents.resize(indices.size());
+    _impl::for_each_face_block(
+        positions, indices, [&](const auto& block, size_t first, int n) {
+            for (int c = 0; c < 3; ++c) {
+                _impl::BlockArray<FT> cot = block.cotangent(c);
+                for (int i = 0; i < n; ++i) {
+                    cotangents[3 * (first + i) + c] = cot(i);
+                }
+            }
+        });
+}
+
+template<typename FT, typename IT>
+void angle_defects(const std::vector<FT>& positions,
+                   const std::vector<IT>& indices,
+                   std::vector<FT>& defects)
+{
+    _impl::check_buffers(positions, indices);
+    std::vector<FT> angles(indices.size());
+    _impl::for_each_face_block(
+        positions, indices, [&](const auto& block, size_t first, int n) {
+            for (int c = 0; c < 3; ++c) {
+                _impl::BlockArray<FT> angle = block.angle(c);
+                for (int i = 0; i < n; ++i) {
+                    angles[3 * (first + i) + c] = angle(i);
+                }
+            }
+        });
+
+    // Scattering to vertices is memory bound, keep it sequential
+    defects.assign(positions.size() / 3, boost::math::constants::two_pi<FT>());
+    for (size_t i = 0; i < indices.size(); ++i) {
+        defects[indices[i]] -= angles[i];
+    }
+}
+
+} // namespace Euclid
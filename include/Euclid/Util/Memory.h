@@ -59,13 +59,16 @@ public:
     /** Move constructor.
      *
      */
-    ProPtr(ProPtr&& pro) noexcept { pro.swap(*this); }
+    ProPtr(ProPtr&& pro) noexcept : _data(nullptr), _own(false)
+    {
+        pro.swap(*this);
+    }
 
     /** Move construct from a derived type.
      *
      */
     template<typename U>
-    ProPtr(ProPtr<U>&& pro) noexcept
+    ProPtr(ProPtr<U>&& pro) noexcept : _data(nullptr), _own(false)
     {
         auto owning = pro.owns();
         auto data = pro.release();
@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Descriptor/ChebyshevHKS.h>
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Euclid/Descriptor/HKS.h>
+#include <Euclid/Geometry/Spectral.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/IO/PlyIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+#include <Euclid/MeshUtil/PrimitiveGenerator.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Mesh = CGAL::Surface_mesh<Kernel::Point_3>;
+
+TEST_CASE("Descriptor, ChebyshevHKS", "[descriptor][chebyshevhks]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+    const int nv = static_cast<int>(num_vertices(mesh));
+
+    Euclid::ChebyshevHKS<Mesh> chebyshev;
+    chebyshev.build(mesh, 20, 100);
+
+    SECTION("default time range")
+    {
+        Eigen::ArrayXXd hks;
+        chebyshev.compute(hks, 50);
+
+        REQUIRE(hks.rows() == 50);
+        REQUIRE(hks.cols() == nv);
+        REQUIRE(chebyshev.order() > 0);
+        for (int i = 0; i < hks.rows(); ++i) {
+            REQUIRE(hks.row(i).sum() == Approx(1.0));
+        }
+    }
+
+    SECTION("subset and blocks")
+    {
+        Eigen::ArrayXXd hks, hks_subset;
+        chebyshev.compute(hks, 50);
+
+        std::vector<Mesh::Vertex_index> subset{Mesh::Vertex_index(7),
+                                               Mesh::Vertex_index(1000),
+                                               Mesh::Vertex_index(0)};
+        chebyshev.compute(hks_subset, subset, 50);
+        REQUIRE(hks_subset.cols() == 3);
+        for (int i = 0; i < 3; ++i) {
+            REQUIRE(hks_subset.col(i).isApprox(hks.col(subset[i])));
+        }
+
+        Eigen::Index count = 0;
+        chebyshev.compute_blocks(
+            [&](Eigen::Index first, const Eigen::ArrayXXd& block) {
+                REQUIRE(first == count);
+                REQUIRE(block.isApprox(hks.middleCols(first, block.cols())));
+                count += block.cols();
+            },
+            500,
+            50);
+        REQUIRE(count == nv);
+    }
+
+    SECTION("against eigen decomposition")
+    {
+        // HKS from a large spectrum is accurate away from the smallest scales
+        Eigen::VectorXd lambdas;
+        Eigen::MatrixXd phis;
+        Euclid::spectrum(mesh, 500, lambdas, phis);
+        Euclid::HKS<Mesh> hks;
+        hks.build(mesh, &lambdas, &phis);
+
+        auto c = 4.0 * std::log(10.0);
+        auto tmin = static_cast<float>(c / lambdas(lambdas.size() - 1));
+        auto tmax = static_cast<float>(c / lambdas(1));
+        Eigen::ArrayXXd expected, approximated;
+        hks.compute(expected, 50, tmin, tmax);
+        chebyshev.compute(approximated, 50, tmin, tmax);
+
+        Eigen::ArrayXXd error = (approximated - expected).abs() / expected;
+        REQUIRE(error.mean() < 0.1);
+    }
+}
+
+TEST_CASE("Descriptor, ChebyshevHKS small mesh",
+          "[descriptor][chebyshevhks]")
+{
+    // Fewer vertices than probes, the probing colors saturate
+    Mesh mesh;
+    Euclid::make_subdivision_sphere(mesh, Kernel::Point_3(0, 0, 0), 1.0, 1);
+    const int nv = static_cast<int>(num_vertices(mesh));
+    REQUIRE(nv < 100);
+
+    Euclid::ChebyshevHKS<Mesh> chebyshev;
+    chebyshev.build(mesh, 20, 100);
+
+    Eigen::ArrayXXd hks;
+    chebyshev.compute(hks, 50);
+    REQUIRE(hks.rows() == 50);
+    REQUIRE(hks.cols() == nv);
+    for (int i = 0; i < hks.rows(); ++i) {
+        REQUIRE(hks.row(i).sum() == Approx(1.0));
+    }
+}
+
+TEST_CASE("Descriptor, ChebyshevHKS benchmark",
+          "[.benchmark][descriptor][chebyshevhks]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("dragon.ply");
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    Euclid::read_ply<3>(fin, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    Eigen::ArrayXXd descriptors;
+    BENCHMARK("HKS, 300 eigenpairs")
+    {
+        Euclid::HKS<Mesh> hks;
+        hks.build(mesh, 300);
+        hks.compute(descriptors);
+    }
+    BENCHMARK("Chebyshev HKS")
+    {
+        Euclid::ChebyshevHKS<Mesh> hks;
+        hks.build(mesh);
+        hks.compute(descriptors);
+    }
+}
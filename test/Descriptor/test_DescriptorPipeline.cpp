@@ -0,0 +1,141 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Descriptor/DescriptorPipeline.h>
+
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Euclid/Descriptor/HKS.h>
+#include <Euclid/Descriptor/SpinImage.h>
+#include <Euclid/Descriptor/WKS.h>
+#include <Euclid/Geometry/Spectral.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/IO/PlyIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Mesh = CGAL::Surface_mesh<Kernel::Point_3>;
+
+TEST_CASE("Descriptor, DescriptorPipeline", "[descriptor][descriptorpipeline]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+    const int nv = static_cast<int>(num_vertices(mesh));
+
+    SECTION("same as separate descriptors")
+    {
+        Euclid::DescriptorPipeline<Mesh> pipeline;
+        pipeline.add(Euclid::HKSParams{});
+        pipeline.add(Euclid::HKSParams{50});
+        pipeline.add(Euclid::WKSParams{});
+        Euclid::SpinImageParams sparams;
+        sparams.image_width = 8;
+        pipeline.add(sparams);
+        pipeline.build(mesh, 100);
+        Euclid::DescriptorBundle<double> bundle;
+        pipeline.compute(bundle);
+
+        Eigen::VectorXd lambdas;
+        Eigen::MatrixXd phis;
+        Euclid::spectrum(mesh, 100, lambdas, phis);
+        REQUIRE(pipeline.eigenvalues().isApprox(lambdas));
+
+        Euclid::HKS<Mesh> hks;
+        hks.build(mesh, &lambdas, &phis);
+        Eigen::ArrayXXd expected;
+        REQUIRE(bundle.hks.size() == 2);
+        hks.compute(expected);
+        REQUIRE(bundle.hks[0].isApprox(expected));
+        hks.compute(expected, 50);
+        REQUIRE(bundle.hks[1].isApprox(expected));
+
+        Euclid::WKS<Mesh> wks;
+        wks.build(mesh, &lambdas, &phis);
+        REQUIRE(bundle.wks.size() == 1);
+        wks.compute(expected);
+        REQUIRE(bundle.wks[0].isApprox(expected));
+
+        Euclid::SpinImage<Mesh> si;
+        si.build(mesh);
+        REQUIRE(pipeline.resolution() == Approx(si.resolution));
+        REQUIRE(bundle.spin_images.size() == 1);
+        si.compute(expected, 1.0f, 8);
+        REQUIRE(bundle.spin_images[0].cols() == nv);
+        REQUIRE((bundle.spin_images[0] == expected).all());
+
+        std::vector<std::string> stages;
+        for (const auto& [stage, seconds] : bundle.timings) {
+            REQUIRE(seconds >= 0.0);
+            stages.push_back(stage);
+        }
+        REQUIRE(stages == std::vector<std::string>{"spectrum",
+                                                   "squared eigenfunctions",
+                                                   "vertex normals",
+                                                   "resolution",
+                                                   "hks 0",
+                                                   "hks 1",
+                                                   "wks 0",
+                                                   "spin images 0",
+                                                   "compute"});
+    }
+
+    SECTION("only the required intermediates")
+    {
+        Euclid::DescriptorPipeline<Mesh> pipeline;
+        pipeline.add(Euclid::SpinImageParams{});
+        pipeline.build(mesh);
+        REQUIRE(pipeline.eigenvalues().size() == 0);
+        REQUIRE(pipeline.vertex_normals().size() == nv);
+
+        Euclid::DescriptorBundle<double> bundle;
+        pipeline.compute(bundle);
+        REQUIRE(bundle.hks.empty());
+        REQUIRE(bundle.wks.empty());
+        REQUIRE(bundle.spin_images.size() == 1);
+        REQUIRE(bundle.spin_images[0].rows() == 256);
+    }
+}
+
+TEST_CASE("Descriptor, DescriptorPipeline benchmark",
+          "[.benchmark][descriptor][descriptorpipeline]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("dragon.ply");
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    Euclid::read_ply<3>(fin, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    BENCHMARK("Separate descriptors")
+    {
+        Eigen::ArrayXXd descriptors;
+        Euclid::HKS<Mesh> hks;
+        hks.build(mesh, 100);
+        hks.compute(descriptors);
+        Euclid::WKS<Mesh> wks;
+        wks.build(mesh, 100);
+        wks.compute(descriptors);
+        Euclid::SpinImage<Mesh> si;
+        si.build(mesh);
+        si.compute(descriptors);
+    }
+    BENCHMARK("Pipeline")
+    {
+        Euclid::DescriptorPipeline<Mesh> pipeline;
+        pipeline.add(Euclid::HKSParams{});
+        pipeline.add(Euclid::WKSParams{});
+        pipeline.add(Euclid::SpinImageParams{});
+        pipeline.build(mesh, 100);
+        Euclid::DescriptorBundle<double> bundle;
+        pipeline.compute(bundle);
+    }
+}
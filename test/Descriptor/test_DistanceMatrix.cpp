@@ -0,0 +1,197 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Descriptor/DistanceMatrix.h>
+
+#include <algorithm>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Euclid/Descriptor/HKS.h>
+#include <Euclid/Descriptor/Histogram.h>
+#include <Euclid/IO/PlyIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Mesh = CGAL::Surface_mesh<Kernel::Point_3>;
+
+// Distance of a pair of descriptors with the functions in Histogram
+static double _pairwise(const Eigen::ArrayXXd& queries,
+                        const Eigen::ArrayXXd& targets,
+                        int i,
+                        int j,
+                        Euclid::HistogramDistance metric)
+{
+    switch (metric) {
+    case Euclid::HistogramDistance::l1:
+        return Euclid::l1(queries.col(i), targets.col(j));
+    case Euclid::HistogramDistance::l2:
+        return Euclid::l2(queries.col(i), targets.col(j));
+    case Euclid::HistogramDistance::chi2:
+        return Euclid::chi2(queries.col(i), targets.col(j));
+    default:
+        return Euclid::chi2_asym(queries.col(i), targets.col(j));
+    }
+}
+
+TEST_CASE("Descriptor, DistanceMatrix", "[descriptor][distancematrix]")
+{
+    // Sizes not divisible by the tiles
+    Eigen::ArrayXXd queries = Eigen::ArrayXXd::Random(50, 150).abs();
+    Eigen::ArrayXXd targets = Eigen::ArrayXXd::Random(50, 1100).abs();
+    const std::vector<Euclid::HistogramDistance> metrics{
+        Euclid::HistogramDistance::l1,
+        Euclid::HistogramDistance::l2,
+        Euclid::HistogramDistance::chi2,
+        Euclid::HistogramDistance::chi2_asym};
+
+    SECTION("full matrix")
+    {
+        for (auto metric : metrics) {
+            Eigen::ArrayXXd distances;
+            Euclid::distance_matrix(queries, targets, distances, metric);
+            REQUIRE(distances.rows() == queries.cols());
+            REQUIRE(distances.cols() == targets.cols());
+            for (int i = 0; i < queries.cols(); ++i) {
+                for (int j = 0; j < targets.cols(); ++j) {
+                    auto expected = _pairwise(queries, targets, i, j, metric);
+                    if (metric == Euclid::HistogramDistance::l2) {
+                        REQUIRE(distances(i, j) == Approx(expected));
+                    }
+                    else {
+                        REQUIRE(distances(i, j) == expected);
+                    }
+                }
+            }
+        }
+
+        Eigen::ArrayXXd distances;
+        Euclid::distance_matrix(queries.col(7), queries, distances);
+        REQUIRE(distances.rows() == 1);
+        REQUIRE(distances(0, 7) == 0.0);
+
+        Eigen::ArrayXXd other = Eigen::ArrayXXd::Random(10, 5);
+        REQUIRE_THROWS(Euclid::distance_matrix(queries, other, distances));
+    }
+
+    SECTION("blocks")
+    {
+        for (auto metric : metrics) {
+            Eigen::ArrayXXd distances;
+            Euclid::distance_matrix(queries, targets, distances, metric);
+
+            Eigen::Index count = 0;
+            Euclid::distance_matrix_blocks(
+                queries,
+                targets,
+                [&](Eigen::Index first, const Eigen::ArrayXXd& block) {
+                    REQUIRE(first == count);
+                    REQUIRE((block ==
+                             distances.middleRows(first, block.rows()))
+                                .all());
+                    count += block.rows();
+                },
+                40,
+                metric);
+            REQUIRE(count == queries.cols());
+        }
+    }
+
+    SECTION("nearest neighbors")
+    {
+        const unsigned k = 5;
+        for (auto metric : metrics) {
+            Eigen::ArrayXXd distances;
+            Euclid::distance_matrix(queries, targets, distances, metric);
+
+            Eigen::ArrayXXi indices;
+            Eigen::ArrayXXd nearest;
+            Euclid::nearest_neighbors(
+                queries, targets, k, indices, nearest, metric);
+            REQUIRE(indices.rows() == k);
+            REQUIRE(indices.cols() == queries.cols());
+            for (int i = 0; i < queries.cols(); ++i) {
+                std::vector<int> order(targets.cols());
+                std::iota(order.begin(), order.end(), 0);
+                std::partial_sort(order.begin(),
+                                  order.begin() + k,
+                                  order.end(),
+                                  [&](int a, int b) {
+                                      return std::make_pair(distances(i, a),
+                                                            a) <
+                                             std::make_pair(distances(i, b),
+                                                            b);
+                                  });
+                for (unsigned j = 0; j < k; ++j) {
+                    REQUIRE(indices(j, i) == order[j]);
+                    REQUIRE(nearest(j, i) == distances(i, order[j]));
+                }
+            }
+        }
+
+        Eigen::ArrayXXi indices;
+        Eigen::ArrayXXd nearest;
+        REQUIRE_THROWS(Euclid::nearest_neighbors(
+            queries, queries.leftCols(3), 4, indices, nearest));
+    }
+}
+
+TEST_CASE("Descriptor, DistanceMatrix benchmark",
+          "[.benchmark][descriptor][distancematrix]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("dragon.ply");
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    Euclid::read_ply<3>(fin, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    Euclid::HKS<Mesh> hks;
+    hks.build(mesh, 100);
+    Eigen::ArrayXXd descriptors;
+    hks.compute(descriptors);
+    Eigen::ArrayXXd queries = descriptors.leftCols(1000);
+
+    Eigen::ArrayXXd distances(queries.cols(), descriptors.cols());
+    BENCHMARK("Pairwise chi2")
+    {
+        for (int j = 0; j < descriptors.cols(); ++j) {
+            for (int i = 0; i < queries.cols(); ++i) {
+                distances(i, j) =
+                    Euclid::chi2(queries.col(i), descriptors.col(j));
+            }
+        }
+    }
+    BENCHMARK("Distance matrix, chi2")
+    {
+        Euclid::distance_matrix(queries,
+                                descriptors,
+                                distances,
+                                Euclid::HistogramDistance::chi2);
+    }
+    BENCHMARK("Pairwise l2")
+    {
+        for (int j = 0; j < descriptors.cols(); ++j) {
+            for (int i = 0; i < queries.cols(); ++i) {
+                distances(i, j) =
+                    Euclid::l2(queries.col(i), descriptors.col(j));
+            }
+        }
+    }
+    BENCHMARK("Distance matrix, l2")
+    {
+        Euclid::distance_matrix(queries, descriptors, distances);
+    }
+
+    Eigen::ArrayXXi neighbors;
+    Eigen::ArrayXXd nearest;
+    BENCHMARK("Nearest neighbors, l2")
+    {
+        Euclid::nearest_neighbors(queries, descriptors, 10, neighbors, nearest);
+    }
+}
@@ -88,6 +88,73 @@ TEST_CASE("Descriptor,HKS", "[descriptor][hks]")
             "hks1.ply", positions, indices, distances);
     }
 
+    SECTION("direct summation")
+    {
+        auto c = 4.0 * std::log(10.0);
+        auto tmin = c / eigenvalues(eigenvalues.size() - 1);
+        auto tmax = c / eigenvalues(1);
+        const unsigned tscales = 10;
+        Eigen::ArrayXXd hks_all;
+        hks.compute(hks_all, tscales, tmin, tmax);
+
+        auto log_tmin = std::log(static_cast<float>(tmin));
+        auto log_tmax = std::log(static_cast<float>(tmax));
+        auto log_tstep = (log_tmax - log_tmin) / tscales;
+        for (unsigned i = 0; i < tscales; ++i) {
+            auto t = std::exp(log_tmin + log_tstep * i);
+            Eigen::VectorXd weights = (-eigenvalues * t).array().exp();
+            Eigen::VectorXd expected =
+                eigenfunctions.array().square().matrix() * weights;
+            expected /= expected.sum();
+            for (auto idx : {idx1, idx2, idx3, idx4}) {
+                REQUIRE(hks_all(i, idx) == Approx(expected(idx)));
+            }
+        }
+    }
+
+    SECTION("subset and blocks")
+    {
+        Eigen::ArrayXXd hks_all, hks_subset;
+        hks.compute(hks_all);
+
+        std::vector<Vertex> subset{
+            Vertex(idx4), Vertex(idx1), Vertex(idx3), Vertex(idx2)};
+        hks.compute(hks_subset, subset);
+        REQUIRE(hks_subset.cols() == 4);
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(hks_subset.col(i).isApprox(hks_all.col(subset[i])));
+        }
+
+        Eigen::Index count = 0;
+        hks.compute_blocks(
+            [&](Eigen::Index first, const Eigen::ArrayXXd& block) {
+                REQUIRE(first == count);
+                REQUIRE(block.isApprox(
+                    hks_all.middleCols(first, block.cols())));
+                count += block.cols();
+            },
+            10000);
+        REQUIRE(count == hks_all.cols());
+    }
+
+    SECTION("copies")
+    {
+        Eigen::ArrayXXd hks_all, hks_copy, hks_shared;
+        hks.compute(hks_all);
+        auto copy = hks;
+        copy.compute(hks_copy);
+        REQUIRE(hks_copy.isApprox(hks_all));
+
+        // The squared eigenfunctions are referenced, so copies and moves keep
+        // pointing at the same matrix
+        Eigen::MatrixXd phi2 = eigenfunctions.array().square().matrix();
+        Euclid::HKS<Mesh> shared;
+        shared.build_squared(mesh, &eigenvalues, &phi2);
+        auto moved = std::move(shared);
+        moved.compute(hks_shared);
+        REQUIRE(hks_shared.isApprox(hks_all));
+    }
+
     SECTION("smaller time range")
     {
         auto c = std::log(10.0);
@@ -128,3 +195,27 @@ TEST_CASE("Descriptor,HKS", "[descriptor][hks]")
             "hks3.ply", positions, indices, distances);
     }
 }
+
+TEST_CASE("Descriptor, HKS benchmark", "[.benchmark][descriptor][hks]")
+{
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    std::string filename(DATA_DIR);
+    filename.append("dragon.ply");
+    Euclid::read_ply<3>(
+        filename, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    Eigen::VectorXd eigenvalues;
+    Eigen::MatrixXd eigenfunctions;
+    Euclid::spectrum(mesh, 300, eigenvalues, eigenfunctions);
+    Euclid::HKS<Mesh> hks;
+    hks.build(mesh, &eigenvalues, &eigenfunctions);
+
+    Eigen::ArrayXXd hks_all;
+    BENCHMARK("300 eigenpairs, 100 time scales")
+    {
+        hks.compute(hks_all, 100);
+    }
+}
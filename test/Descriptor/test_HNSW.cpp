@@ -0,0 +1,176 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Descriptor/HNSW.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Euclid/Descriptor/DistanceMatrix.h>
+#include <Euclid/Descriptor/HKS.h>
+#include <Euclid/IO/PlyIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+#include <Euclid/Util/Serialize.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Mesh = CGAL::Surface_mesh<Kernel::Point_3>;
+
+// Positive descriptors around a few centers, like histograms of similar shapes
+static Eigen::ArrayXXd _clustered_descriptors(int dim, int count, int seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> cluster(0, 19);
+    std::normal_distribution<double> noise(0.0, 0.1);
+    std::mt19937 center_gen(0);
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    Eigen::ArrayXXd centers(dim, 20);
+    for (int i = 0; i < centers.size(); ++i) {
+        centers(i) = uniform(center_gen);
+    }
+    Eigen::ArrayXXd descriptors(dim, count);
+    for (int j = 0; j < count; ++j) {
+        auto c = cluster(gen);
+        for (int i = 0; i < dim; ++i) {
+            descriptors(i, j) = std::abs(centers(i, c) + noise(gen));
+        }
+    }
+    return descriptors;
+}
+
+// Fraction of the exact k nearest neighbors found by the index
+static double _recall(const Eigen::ArrayXXi& exact,
+                      const Eigen::ArrayXXi& approximated)
+{
+    int found = 0;
+    for (int j = 0; j < exact.cols(); ++j) {
+        for (int i = 0; i < exact.rows(); ++i) {
+            found += (approximated.col(j) == exact(i, j)).any();
+        }
+    }
+    return static_cast<double>(found) / exact.size();
+}
+
+TEST_CASE("Descriptor, HNSW", "[descriptor][hnsw]")
+{
+    auto descriptors = _clustered_descriptors(32, 5000, 1);
+    auto queries = _clustered_descriptors(32, 200, 2);
+    const unsigned k = 10;
+
+    SECTION("recall")
+    {
+        for (auto metric :
+             {Euclid::HistogramDistance::l2, Euclid::HistogramDistance::chi2}) {
+            Euclid::HNSW<double> index;
+            index.build(descriptors, metric);
+            REQUIRE(index.size() == 5000);
+            REQUIRE(index.dim() == 32);
+
+            Eigen::ArrayXXi exact, approximated;
+            Eigen::ArrayXXd exact_distances, distances;
+            Euclid::nearest_neighbors(
+                queries, descriptors, k, exact, exact_distances, metric);
+            index.query(queries, k, approximated, distances, 100);
+            REQUIRE(approximated.rows() == k);
+            REQUIRE(approximated.cols() == queries.cols());
+            REQUIRE(_recall(exact, approximated) > 0.95);
+            for (int j = 0; j < queries.cols(); ++j) {
+                for (unsigned i = 1; i < k; ++i) {
+                    REQUIRE(distances(i - 1, j) <= distances(i, j));
+                }
+            }
+
+            // Every descriptor finds itself
+            index.query(descriptors.leftCols(100), 1, approximated, distances);
+            for (int j = 0; j < 100; ++j) {
+                REQUIRE(distances(0, j) == 0.0);
+            }
+        }
+    }
+
+    SECTION("add")
+    {
+        Euclid::HNSW<double> index;
+        index.build(descriptors.leftCols(2000), Euclid::HistogramDistance::l2);
+        index.add(descriptors.rightCols(3000));
+        REQUIRE(index.size() == 5000);
+
+        Eigen::ArrayXXi exact, approximated;
+        Eigen::ArrayXXd exact_distances, distances;
+        Euclid::nearest_neighbors(
+            queries, descriptors, k, exact, exact_distances);
+        index.query(queries, k, approximated, distances, 100);
+        REQUIRE(_recall(exact, approximated) > 0.95);
+
+        REQUIRE_THROWS(index.add(Eigen::ArrayXXd::Random(16, 10)));
+        REQUIRE_THROWS(index.query(queries, 6000, approximated, distances));
+    }
+
+    SECTION("serialization")
+    {
+        Euclid::HNSW<float> index;
+        index.build(descriptors.cast<float>(), Euclid::HistogramDistance::chi2);
+        std::string fcereal(TMP_DIR);
+        fcereal.append("hnsw.cereal");
+        Euclid::serialize(fcereal, index);
+
+        Euclid::HNSW<float> loaded;
+        Euclid::deserialize(fcereal, loaded);
+        REQUIRE(loaded.size() == index.size());
+        REQUIRE(loaded.dim() == index.dim());
+
+        Eigen::ArrayXXi expected, result;
+        Eigen::ArrayXXf expected_distances, distances;
+        index.query(queries.cast<float>(), k, expected, expected_distances);
+        loaded.query(queries.cast<float>(), k, result, distances);
+        REQUIRE((result == expected).all());
+        REQUIRE((distances == expected_distances).all());
+    }
+}
+
+TEST_CASE("Descriptor, HNSW benchmark", "[.benchmark][descriptor][hnsw]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("dragon.ply");
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    Euclid::read_ply<3>(fin, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    Euclid::HKS<Mesh> hks;
+    hks.build(mesh, 100);
+    Eigen::ArrayXXd descriptors;
+    hks.compute(descriptors);
+    Eigen::ArrayXXd queries = descriptors.leftCols(1000);
+    const unsigned k = 10;
+
+    Euclid::HNSW<double> index;
+    BENCHMARK("Build, chi2")
+    {
+        index.build(descriptors, Euclid::HistogramDistance::chi2);
+    }
+
+    // Recall against latency for growing search widths
+    Eigen::ArrayXXi exact, approximated;
+    Eigen::ArrayXXd exact_distances, distances;
+    BENCHMARK("Exact search, chi2")
+    {
+        Euclid::nearest_neighbors(queries,
+                                  descriptors,
+                                  k,
+                                  exact,
+                                  exact_distances,
+                                  Euclid::HistogramDistance::chi2);
+    }
+    for (unsigned ef : {10u, 20u, 50u, 100u, 200u}) {
+        index.query(queries, k, approximated, distances, ef);
+        WARN("ef " << ef << ", recall " << _recall(exact, approximated));
+        BENCHMARK("Query, chi2, ef " + std::to_string(ef))
+        {
+            index.query(queries, k, approximated, distances, ef);
+        }
+    }
+}
@@ -28,4 +28,24 @@ TEST_CASE("Descriptor, Histogram", "[distance][histogram]")
         REQUIRE(Euclid::chi2_asym(d1, d2.col(1)) == 5.0);
         REQUIRE(Euclid::chi2_asym(d2.col(0), d3.array()) == 11.0 / 6.0);
     }
+
+    SECTION("compare sparse vectors")
+    {
+        Eigen::Array4d d1(1.0, 0.0, 1.0, 0.0);
+        Eigen::Array4d d2(2.0, 0.0, 0.0, 3.0);
+        Eigen::SparseMatrix<double> s(4, 2);
+        s.insert(0, 0) = 1.0;
+        s.insert(2, 0) = 1.0;
+        s.insert(0, 1) = 2.0;
+        s.insert(3, 1) = 3.0;
+        s.makeCompressed();
+        Eigen::SparseVector<double> v1 = s.col(0);
+
+        REQUIRE(Euclid::l1(s.col(0), s.col(1)) == Euclid::l1(d1, d2));
+        REQUIRE(Euclid::l2(s.col(0), s.col(1)) == Euclid::l2(d1, d2));
+        REQUIRE(Euclid::chi2(s.col(0), s.col(1)) == Euclid::chi2(d1, d2));
+        REQUIRE(Euclid::chi2_asym(s.col(1), s.col(0)) ==
+                Euclid::chi2_asym(d2, d1));
+        REQUIRE(Euclid::chi2(v1, s.col(0)) == 0.0);
+    }
 }
@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Descriptor/Quantization.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Euclid/Descriptor/HKS.h>
+#include <Euclid/Descriptor/Histogram.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Mesh = CGAL::Surface_mesh<Kernel::Point_3>;
+
+// Fraction of the descriptors whose nearest neighbor under quantization is
+// among their few nearest neighbors in full precision
+template<typename T>
+static double _matching_accuracy(const Eigen::ArrayXXd& descriptors,
+                                 int neighbors)
+{
+    Euclid::QuantizedDescriptors<T> quantized(descriptors);
+    const auto n = static_cast<int>(descriptors.cols());
+    Eigen::ArrayXd distances(n);
+    int matched = 0, queries = 0;
+    for (int j = 0; j < n; j += 10, ++queries) {
+        int nearest = -1;
+        float dmin = std::numeric_limits<float>::max();
+        for (int i = 0; i < n; ++i) {
+            distances(i) = Euclid::chi2(descriptors.col(j), descriptors.col(i));
+            auto d = Euclid::chi2(quantized.col(j), quantized.col(i));
+            if (i != j && d < dmin) {
+                dmin = d;
+                nearest = i;
+            }
+        }
+        // The descriptor itself is at distance 0
+        auto rank = (distances < distances(nearest)).count() - 1;
+        matched += rank < neighbors;
+    }
+    return static_cast<double>(matched) / queries;
+}
+
+TEST_CASE("Descriptor, Quantization", "[descriptor][quantization]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    Euclid::HKS<Mesh> hks;
+    hks.build(mesh, 100);
+    Eigen::ArrayXXd descriptors;
+    hks.compute(descriptors);
+
+    SECTION("round trip")
+    {
+        Euclid::QuantizedDescriptors<float> f32(descriptors);
+        Euclid::QuantizedDescriptors<Eigen::half> f16(descriptors);
+        Euclid::QuantizedDescriptors<int8_t> i8(descriptors);
+        REQUIRE(f32.bytes() == descriptors.size() * 4);
+        REQUIRE(f16.bytes() == descriptors.size() * 2 + descriptors.cols() * 4);
+        REQUIRE(i8.bytes() == descriptors.size() + descriptors.cols() * 4);
+
+        Eigen::ArrayXXd restored;
+        Eigen::ArrayXd vmax = descriptors.colwise().maxCoeff().transpose();
+        f32.dequantize(restored);
+        REQUIRE(((restored - descriptors).abs() / descriptors).maxCoeff() <
+                1e-6);
+        f16.dequantize(restored);
+        for (int j = 0; j < descriptors.cols(); ++j) {
+            REQUIRE((restored.col(j) - descriptors.col(j)).abs().maxCoeff() <=
+                    vmax(j) / 2048.0);
+        }
+        i8.dequantize(restored);
+        for (int j = 0; j < descriptors.cols(); ++j) {
+            REQUIRE((restored.col(j) - descriptors.col(j)).abs().maxCoeff() <=
+                    vmax(j) / 254.0 * 1.001);
+        }
+    }
+
+    SECTION("streamed blocks")
+    {
+        Euclid::QuantizedDescriptors<int8_t> expected(descriptors);
+        Euclid::QuantizedDescriptors<int8_t> streamed(descriptors.rows(),
+                                                      descriptors.cols());
+        hks.compute_blocks(
+            [&](Eigen::Index first, const Eigen::ArrayXXd& block) {
+                streamed.set(first, block);
+            },
+            300);
+        REQUIRE((streamed.data() == expected.data()).all());
+        REQUIRE((streamed.scales() == expected.scales()).all());
+    }
+
+    SECTION("distances")
+    {
+        Euclid::QuantizedDescriptors<int8_t> i8(descriptors);
+        Eigen::ArrayXXf restored;
+        i8.dequantize(restored);
+        auto d1 = i8.col(0);
+        auto d2 = i8.col(1);
+        REQUIRE(Euclid::l1(d1, d2) ==
+                Approx(Euclid::l1(restored.col(0), restored.col(1))));
+        REQUIRE(Euclid::l2(d1, d2) ==
+                Approx(Euclid::l2(restored.col(0), restored.col(1))));
+        REQUIRE(Euclid::chi2(d1, d2) ==
+                Approx(Euclid::chi2(restored.col(0), restored.col(1))));
+        REQUIRE(Euclid::chi2_asym(d1, d2) ==
+                Approx(Euclid::chi2_asym(restored.col(0), restored.col(1))));
+    }
+
+    SECTION("matching accuracy")
+    {
+        auto f32 = _matching_accuracy<float>(descriptors, 1);
+        auto f16 = _matching_accuracy<Eigen::half>(descriptors, 1);
+        auto i8 = _matching_accuracy<int8_t>(descriptors, 1);
+        REQUIRE(f32 == 1.0);
+        REQUIRE(f16 > 0.95);
+        REQUIRE(i8 > 0.75);
+
+        // The mismatches of int8 are close ones
+        REQUIRE(_matching_accuracy<int8_t>(descriptors, 5) > 0.95);
+    }
+}
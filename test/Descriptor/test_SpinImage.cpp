@@ -1,7 +1,10 @@
 #include <catch2/catch.hpp>
 #include <Euclid/Descriptor/SpinImage.h>
 
+#include <cmath>
+#include <tuple>
 #include <vector>
+#include <boost/math/constants/constants.hpp>
 #include <CGAL/Simple_cartesian.h>
 #include <CGAL/Surface_mesh.h>
 #include <Euclid/MeshUtil/MeshHelpers.h>
@@ -44,6 +47,42 @@ static void _write_distances_to_colored_mesh(
     Euclid::write_ply<3>(fout, positions, nullptr, nullptr, &indices, &colors);
 }
 
+// Spin image of a vertex from all the vertices of the mesh
+static Eigen::ArrayXd _brute_force_spin_image(
+    const Euclid::SpinImage<Mesh>& si,
+    Vertex vi,
+    float bin_scale,
+    int image_width,
+    float support_angle)
+{
+    const auto& mesh = *si.mesh;
+    const auto& vnormals = *si.vnormals;
+    auto cos_range =
+        std::cos(support_angle * boost::math::float_constants::degree);
+    auto bin_size = si.resolution * bin_scale;
+    auto beta_max = bin_size * image_width * 0.5;
+    auto pi = mesh.point(vi);
+    auto ni = vnormals[vi];
+    Eigen::ArrayXd image = Eigen::ArrayXd::Zero(image_width * image_width);
+    for (auto vj : vertices(mesh)) {
+        auto pj = mesh.point(vj);
+        if (ni * vnormals[vj] < cos_range) { continue; }
+        auto beta = ni * (pj - pi);
+        auto alpha = std::sqrt((pj - pi).squared_length() - beta * beta);
+        auto col = static_cast<int>(std::floor(alpha / bin_size));
+        if (col > image_width - 2) { continue; }
+        auto row = static_cast<int>(std::floor((beta_max - beta) / bin_size));
+        if (row > image_width - 2 || row < 0) { continue; }
+        auto a = alpha / bin_size - col;
+        auto b = beta_max / bin_size - beta / bin_size - row;
+        image(row * image_width + col) += (1.0f - a) * (1.0f - b);
+        image(row * image_width + col + 1) += a * (1.0f - b);
+        image((row + 1) * image_width + col) += (1.0f - a) * b;
+        image((row + 1) * image_width + col + 1) += a * b;
+    }
+    return image;
+}
+
 TEST_CASE("Descriptor, SpinImage", "[descriptor][spinimage]")
 {
     std::vector<double> positions;
@@ -80,6 +119,15 @@ TEST_CASE("Descriptor, SpinImage", "[descriptor][spinimage]")
         REQUIRE(distances[idx2] < distances[idx4]);
         REQUIRE(distances[idx3] < distances[idx4]);
 
+        std::vector<Vertex> subset{
+            Vertex(idx4), Vertex(idx1), Vertex(idx3), Vertex(idx2)};
+        Eigen::ArrayXXd si_subset;
+        si.compute(si_subset, subset, 1.0f, width, angle);
+        REQUIRE(si_subset.cols() == 4);
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE((si_subset.col(i) == si_all.col(subset[i])).all());
+        }
+
         // output spin images
         _write_spin_image("spinimage1_1.png", si_all.col(idx1), width);
         _write_spin_image("spinimage1_2.png", si_all.col(idx2), width);
@@ -150,4 +198,105 @@ TEST_CASE("Descriptor, SpinImage", "[descriptor][spinimage]")
         _write_distances_to_colored_mesh(
             "spinimage3.ply", positions, indices, distances);
     }
+
+    SECTION("same as visiting all vertices")
+    {
+        Euclid::SpinImage<Mesh> si;
+        si.build(mesh);
+
+        std::vector<Vertex> subset;
+        for (int i = 0; i < static_cast<int>(num_vertices(mesh)); i += 997) {
+            subset.emplace_back(i);
+        }
+        for (auto [scale, width, angle] : {std::make_tuple(1.0f, 16, 90.0f),
+                                           std::make_tuple(2.0f, 8, 60.0f),
+                                           std::make_tuple(0.5f, 32, 180.0f)}) {
+            Eigen::ArrayXXd si_subset;
+            si.compute(si_subset, subset, scale, width, angle);
+            for (size_t i = 0; i < subset.size(); ++i) {
+                auto expected =
+                    _brute_force_spin_image(si, subset[i], scale, width, angle);
+                REQUIRE((si_subset.col(i) == expected).all());
+            }
+        }
+    }
+
+    SECTION("sparse images")
+    {
+        Euclid::SpinImage<Mesh> si;
+        si.build(mesh);
+
+        Eigen::ArrayXXd si_dense;
+        Eigen::SparseMatrix<double> si_sparse;
+        si.compute(si_dense);
+        si.compute(si_sparse);
+        REQUIRE(si_sparse.rows() == si_dense.rows());
+        REQUIRE(si_sparse.cols() == si_dense.cols());
+        REQUIRE((Eigen::ArrayXXd(si_sparse.toDense()) == si_dense).all());
+        REQUIRE(si_sparse.nonZeros() < si_dense.size() / 2);
+
+        for (auto idx : {idx2, idx3, idx4}) {
+            auto chi2 = Euclid::chi2(si_dense.col(idx1), si_dense.col(idx));
+            auto l2 = Euclid::l2(si_dense.col(idx1), si_dense.col(idx));
+            REQUIRE(Euclid::chi2(si_sparse.col(idx1), si_sparse.col(idx)) ==
+                    Approx(chi2));
+            REQUIRE(Euclid::l2(si_sparse.col(idx1), si_sparse.col(idx)) ==
+                    Approx(l2));
+        }
+
+        std::vector<Vertex> subset{Vertex(idx4), Vertex(idx1)};
+        si.compute(si_sparse, subset);
+        REQUIRE(si_sparse.cols() == 2);
+        REQUIRE((Eigen::ArrayXd(si_sparse.col(1).toDense()) ==
+                 si_dense.col(idx1))
+                    .all());
+    }
+}
+
+TEST_CASE("Descriptor, SpinImage benchmark",
+          "[.benchmark][descriptor][spinimage]")
+{
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    std::string filename(DATA_DIR);
+    filename.append("dragon.ply");
+    Euclid::read_ply<3>(
+        filename, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    Euclid::SpinImage<Mesh> si;
+    si.build(mesh);
+    Eigen::ArrayXXd descriptors;
+    BENCHMARK("Spin images")
+    {
+        si.compute(descriptors);
+    }
+    Eigen::SparseMatrix<double> sparse_descriptors;
+    BENCHMARK("Sparse spin images")
+    {
+        si.compute(sparse_descriptors);
+    }
+
+    // Memory of the sparse images against the dense ones, and the throughput
+    // of matching one image against all
+    WARN("Dense bytes: " << descriptors.size() * sizeof(double)
+                         << ", sparse bytes: "
+                         << sparse_descriptors.nonZeros() *
+                                    (sizeof(double) + sizeof(int)) +
+                                sparse_descriptors.cols() * sizeof(int));
+    std::vector<double> distances(descriptors.cols());
+    BENCHMARK("Dense chi2 against all")
+    {
+        for (int i = 0; i < descriptors.cols(); ++i) {
+            distances[i] = Euclid::chi2(descriptors.col(0), descriptors.col(i));
+        }
+    }
+    BENCHMARK("Sparse chi2 against all")
+    {
+        for (int i = 0; i < sparse_descriptors.cols(); ++i) {
+            distances[i] = Euclid::chi2(sparse_descriptors.col(0),
+                                        sparse_descriptors.col(i));
+        }
+    }
 }
@@ -88,6 +88,73 @@ TEST_CASE("Descriptor, WKS", "[descriptor][wks]")
             "wks1.ply", positions, indices, distances);
     }
 
+    SECTION("direct summation")
+    {
+        const unsigned escales = 10;
+        const float emin = -2.0f, emax = 4.0f, sigma = 0.5f;
+        Eigen::ArrayXXd wks_all;
+        wks.compute(wks_all, escales, emin, emax, sigma);
+
+        Eigen::ArrayXd loglambdas = eigenvalues.array().abs().log();
+        auto estep = (emax - emin) / escales;
+        for (unsigned i = 0; i < escales; ++i) {
+            auto e = emin + estep * i;
+            for (auto idx : {idx1, idx2, idx3, idx4}) {
+                double sum = 0.0, ce = 0.0;
+                for (int j = 1; j < eigenvalues.size(); ++j) {
+                    auto d = e - loglambdas(j);
+                    auto w = std::exp(-d * d * 0.5 / (sigma * sigma));
+                    ce += w;
+                    sum += w * eigenfunctions(idx, j) * eigenfunctions(idx, j);
+                }
+                REQUIRE(wks_all(i, idx) == Approx(sum / ce));
+            }
+        }
+    }
+
+    SECTION("subset and blocks")
+    {
+        Eigen::ArrayXXd wks_all, wks_subset;
+        wks.compute(wks_all);
+
+        std::vector<Vertex> subset{
+            Vertex(idx4), Vertex(idx1), Vertex(idx3), Vertex(idx2)};
+        wks.compute(wks_subset, subset);
+        REQUIRE(wks_subset.cols() == 4);
+        for (int i = 0; i < 4; ++i) {
+            REQUIRE(wks_subset.col(i).isApprox(wks_all.col(subset[i])));
+        }
+
+        Eigen::Index count = 0;
+        wks.compute_blocks(
+            [&](Eigen::Index first, const Eigen::ArrayXXd& block) {
+                REQUIRE(first == count);
+                REQUIRE(block.isApprox(
+                    wks_all.middleCols(first, block.cols())));
+                count += block.cols();
+            },
+            10000);
+        REQUIRE(count == wks_all.cols());
+    }
+
+    SECTION("copies")
+    {
+        Eigen::ArrayXXd wks_all, wks_copy, wks_shared;
+        wks.compute(wks_all);
+        auto copy = wks;
+        copy.compute(wks_copy);
+        REQUIRE(wks_copy.isApprox(wks_all));
+
+        // The squared eigenfunctions are referenced, so copies and moves keep
+        // pointing at the same matrix
+        Eigen::MatrixXd phi2 = eigenfunctions.array().square().matrix();
+        Euclid::WKS<Mesh> shared;
+        shared.build_squared(mesh, &eigenvalues, &phi2);
+        auto moved = std::move(shared);
+        moved.compute(wks_shared);
+        REQUIRE(wks_shared.isApprox(wks_all));
+    }
+
     SECTION("smaller energy range")
     {
         Eigen::Matrix3f A;
@@ -142,3 +209,27 @@ TEST_CASE("Descriptor, WKS", "[descriptor][wks]")
             "wks3.ply", positions, indices, distances);
     }
 }
+
+TEST_CASE("Descriptor, WKS benchmark", "[.benchmark][descriptor][wks]")
+{
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    std::string filename(DATA_DIR);
+    filename.append("dragon.ply");
+    Euclid::read_ply<3>(
+        filename, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    Eigen::VectorXd eigenvalues;
+    Eigen::MatrixXd eigenfunctions;
+    Euclid::spectrum(mesh, 300, eigenvalues, eigenfunctions);
+    Euclid::WKS<Mesh> wks;
+    wks.build(mesh, &eigenvalues, &eigenfunctions);
+
+    Eigen::ArrayXXd wks_all;
+    BENCHMARK("300 eigenpairs, 100 energy scales")
+    {
+        wks.compute(wks_all, 100);
+    }
+}
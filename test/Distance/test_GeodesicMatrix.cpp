@@ -0,0 +1,160 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Distance/GeodesicMatrix.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Point_3 = Kernel::Point_3;
+using Mesh = CGAL::Surface_mesh<Point_3>;
+
+template<typename T>
+static Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+read_matrix(const std::string& filename, Eigen::Index rows, Eigen::Index cols)
+{
+    Eigen::Array<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> matrix(
+        rows, cols);
+    std::ifstream stream(filename, std::ios::binary | std::ios::ate);
+    REQUIRE(static_cast<size_t>(stream.tellg()) == matrix.size() * sizeof(T));
+    stream.seekg(0);
+    stream.read(reinterpret_cast<char*>(matrix.data()),
+                matrix.size() * sizeof(T));
+    return matrix;
+}
+
+TEST_CASE("Distance, Geodesic matrix", "[distance][geodesicmatrix]")
+{
+    std::vector<float> positions;
+    std::vector<unsigned> indices;
+    std::string fin(DATA_DIR);
+    fin.append("kitten.off");
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+    const auto nv = static_cast<int>(num_vertices(mesh));
+
+    Euclid::GeodesicsInHeat<Mesh> heat_method;
+    heat_method.build(mesh, 4.0f);
+
+    SECTION("all pairs")
+    {
+        std::vector<Mesh::Vertex_index> sources;
+        for (auto v : vertices(mesh)) {
+            sources.push_back(v);
+        }
+        Eigen::ArrayXXd batch;
+        heat_method.compute_batch(sources, batch);
+        Eigen::ArrayXXd expected = (batch + batch.transpose()) * 0.5;
+
+        std::string fout(TMP_DIR);
+        fout.append("kitten_geodesic_matrix.bin");
+        // The progress is reported from the worker threads, so it's only
+        // checked afterwards
+        size_t done = 0;
+        bool increasing = true;
+        Euclid::geodesic_matrix(heat_method,
+                                fout,
+                                Euclid::GeodesicPrecision::float32,
+                                100,
+                                [&](size_t count, size_t total) {
+                                    increasing = increasing && count > done &&
+                                                 total == sources.size();
+                                    done = count;
+                                });
+        REQUIRE(increasing);
+        REQUIRE(done == sources.size());
+
+        auto geodesics = read_matrix<float>(fout, nv, nv);
+        REQUIRE((geodesics == geodesics.transpose()).all());
+        auto margin = 1e-5 * expected.maxCoeff();
+        for (int i = 0; i < nv; i += 7) {
+            for (int j = 0; j < nv; ++j) {
+                REQUIRE(geodesics(i, j) ==
+                        Approx(expected(i, j)).margin(margin));
+            }
+        }
+    }
+
+    SECTION("landmarks in half precision")
+    {
+        std::vector<Mesh::Vertex_index> landmarks;
+        for (int i = 0; i < nv; i += nv / 10) {
+            landmarks.emplace_back(i);
+        }
+        Eigen::ArrayXXd batch;
+        heat_method.compute_batch(landmarks, batch);
+
+        std::string fout(TMP_DIR);
+        fout.append("kitten_geodesic_landmarks.bin");
+        Euclid::geodesic_matrix(heat_method,
+                                landmarks,
+                                fout,
+                                Euclid::GeodesicPrecision::float16,
+                                3);
+
+        auto geodesics = read_matrix<Eigen::half>(
+            fout, static_cast<Eigen::Index>(landmarks.size()), nv);
+        for (size_t i = 0; i < landmarks.size(); ++i) {
+            for (int j = 0; j < nv; ++j) {
+                REQUIRE(static_cast<float>(geodesics(i, j)) ==
+                        Approx(batch(j, i)).epsilon(1e-3).margin(1e-4));
+            }
+        }
+    }
+
+    SECTION("errors")
+    {
+        Euclid::GeodesicsInHeat<Mesh> empty;
+        std::string fout(TMP_DIR);
+        fout.append("kitten_geodesic_matrix.bin");
+        REQUIRE_THROWS(Euclid::geodesic_matrix(empty, fout));
+        REQUIRE_THROWS(Euclid::geodesic_matrix(
+            heat_method, fout, Euclid::GeodesicPrecision::float32, 0));
+
+        // Exceptions thrown in the worker threads reach the caller
+        REQUIRE_THROWS_AS(
+            Euclid::geodesic_matrix(heat_method,
+                                    fout,
+                                    Euclid::GeodesicPrecision::float32,
+                                    100,
+                                    [](size_t, size_t) {
+                                        throw std::logic_error("Cancelled.");
+                                    }),
+            std::logic_error);
+    }
+}
+
+TEST_CASE("Distance, Geodesic matrix benchmark",
+          "[.benchmark][distance][geodesicmatrix]")
+{
+    std::vector<float> positions;
+    std::vector<unsigned> indices;
+    std::string fin(DATA_DIR);
+    fin.append("kitten.off");
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    Euclid::GeodesicsInHeat<Mesh> heat_method;
+    heat_method.build(mesh);
+    std::string fout(TMP_DIR);
+    fout.append("kitten_geodesic_matrix.bin");
+
+    BENCHMARK("All pairs")
+    {
+        Euclid::geodesic_matrix(heat_method, fout);
+    }
+    BENCHMARK("All pairs in half precision")
+    {
+        Euclid::geodesic_matrix(
+            heat_method, fout, Euclid::GeodesicPrecision::float16);
+    }
+}
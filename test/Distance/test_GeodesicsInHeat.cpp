@@ -55,3 +55,193 @@ TEST_CASE("Geodesics, Heat method", "[geodesics][heat]")
     fout.append("kitten_geodesics_heat.ply");
     Euclid::write_ply<3>(fout, positions, nullptr, nullptr, &indices, &colors);
 }
+
+TEST_CASE("Geodesics, Heat method with multiple sources", "[geodesics][heat]")
+{
+    std::vector<float> positions;
+    std::vector<unsigned> indices;
+    std::string fin(DATA_DIR);
+    fin.append("kitten.off");
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+    const auto nv = static_cast<int>(num_vertices(mesh));
+
+    Euclid::GeodesicsInHeat<Mesh> heat_method;
+    heat_method.build(mesh, 4.0f);
+
+    std::vector<Mesh::Vertex_index> sources;
+    for (int i = 0; i < nv; i += nv / 10) {
+        sources.emplace_back(i);
+    }
+
+    SECTION("operators")
+    {
+        const auto nf = static_cast<int>(num_faces(mesh));
+        REQUIRE(heat_method.gradient_mat.rows() == 3 * nf);
+        REQUIRE(heat_method.gradient_mat.cols() == nv);
+        REQUIRE(heat_method.divergence_mat.rows() == nv);
+        REQUIRE(heat_method.divergence_mat.cols() == 3 * nf);
+
+        // The divergence of the gradient is the cotangent Laplacian
+        Eigen::SparseMatrix<double> laplacian =
+            heat_method.divergence_mat * heat_method.gradient_mat;
+        Eigen::SparseMatrix<double> residual =
+            laplacian + *heat_method.cot_mat;
+        REQUIRE(residual.norm() < 1e-8 * heat_method.cot_mat->norm());
+    }
+
+    SECTION("batch")
+    {
+        Eigen::ArrayXXd geodesics;
+        heat_method.compute_batch(sources, geodesics, 4);
+        REQUIRE(geodesics.rows() == nv);
+        REQUIRE(geodesics.cols() == static_cast<int>(sources.size()));
+
+        std::vector<double> single;
+        for (size_t j = 0; j < sources.size(); ++j) {
+            heat_method.compute(sources[j], single);
+            REQUIRE(geodesics(sources[j], j) == 0.0);
+            auto margin = 1e-10 * geodesics.col(j).maxCoeff();
+            for (int i = 0; i < nv; ++i) {
+                REQUIRE(geodesics(i, j) == Approx(single[i]).margin(margin));
+            }
+        }
+    }
+
+    SECTION("set of sources")
+    {
+        std::vector<double> geodesics;
+        heat_method.compute(sources, geodesics);
+        REQUIRE(geodesics.size() == static_cast<size_t>(nv));
+
+        // Close to the distance to the nearest source
+        Eigen::ArrayXXd batch;
+        heat_method.compute_batch(sources, batch);
+        Eigen::ArrayXd nearest = batch.rowwise().minCoeff();
+        auto gmax = nearest.maxCoeff();
+        REQUIRE(*std::max_element(geodesics.begin(), geodesics.end()) ==
+                Approx(gmax).epsilon(0.2));
+        for (auto v : sources) {
+            REQUIRE(geodesics[v] < 0.1 * gmax);
+        }
+    }
+
+    SECTION("concurrent queries")
+    {
+        // Every thread queries the shared factors with its own workspace
+        const auto& shared = heat_method;
+        const auto ns = static_cast<int>(sources.size());
+        Eigen::ArrayXXd concurrent(nv, ns);
+#pragma omp parallel
+        {
+            decltype(heat_method)::Workspace workspace;
+            std::vector<double> geodesics;
+
+#pragma omp for
+            for (int j = 0; j < ns; ++j) {
+                shared.compute(sources[j], geodesics, &workspace);
+                for (int i = 0; i < nv; ++i) {
+                    concurrent(i, j) = geodesics[i];
+                }
+            }
+        }
+
+        std::vector<double> single;
+        for (int j = 0; j < ns; ++j) {
+            shared.compute(sources[j], single);
+            for (int i = 0; i < nv; ++i) {
+                REQUIRE(concurrent(i, j) == Approx(single[i]));
+            }
+        }
+    }
+
+    SECTION("cached scales")
+    {
+        std::vector<double> g1, g2, g3;
+        heat_method.compute(sources[1], g1);
+        const auto* solver = &heat_method.heat_solver();
+
+        // Switching back reuses the same factorization
+        heat_method.scale(5.0f);
+        heat_method.compute(sources[1], g2);
+        REQUIRE(&heat_method.heat_solver() != solver);
+        heat_method.scale(4.0f);
+        REQUIRE(&heat_method.heat_solver() == solver);
+        heat_method.compute(sources[1], g3);
+        REQUIRE(g3 == g1);
+
+        Euclid::GeodesicsInHeat<Mesh> empty;
+        REQUIRE_THROWS(empty.heat_solver());
+
+        // A recycled factorization equals a fresh one
+        heat_method.cache_size(1);
+        heat_method.scale(5.0f);
+        heat_method.compute(sources[1], g3);
+        Euclid::GeodesicsInHeat<Mesh> fresh;
+        fresh.build(mesh, 5.0f);
+        fresh.compute(sources[1], g1);
+        for (int i = 0; i < nv; ++i) {
+            REQUIRE(g3[i] == Approx(g2[i]));
+            REQUIRE(g3[i] == Approx(g1[i]));
+        }
+        REQUIRE_THROWS(heat_method.cache_size(0));
+    }
+}
+
+TEST_CASE("Geodesics, Heat method benchmark", "[.benchmark][geodesics][heat]")
+{
+    std::vector<float> positions;
+    std::vector<unsigned> indices;
+    std::string fin(DATA_DIR);
+    fin.append("kitten.off");
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+    const auto nv = static_cast<int>(num_vertices(mesh));
+
+    Euclid::GeodesicsInHeat<Mesh> heat_method;
+    heat_method.build(mesh);
+    std::vector<Mesh::Vertex_index> sources;
+    for (int i = 0; i < nv; i += nv / 100) {
+        sources.emplace_back(i);
+    }
+
+    std::vector<double> geodesics;
+    BENCHMARK("One source at a time")
+    {
+        for (auto v : sources) {
+            heat_method.compute(v, geodesics);
+        }
+    }
+    BENCHMARK("Concurrent sources")
+    {
+#pragma omp parallel
+        {
+            decltype(heat_method)::Workspace workspace;
+            std::vector<double> local;
+
+#pragma omp for schedule(dynamic)
+            for (int j = 0; j < static_cast<int>(sources.size()); ++j) {
+                heat_method.compute(sources[j], local, &workspace);
+            }
+        }
+    }
+    Eigen::ArrayXXd batch;
+    BENCHMARK("Batch")
+    {
+        heat_method.compute_batch(sources, batch);
+    }
+
+    // Sweep the scales twice, the second sweep only hits the cache
+    const std::vector<float> scales{1.0f, 2.0f, 4.0f, 8.0f};
+    BENCHMARK("Scale sweep")
+    {
+        for (int i = 0; i < 2; ++i) {
+            for (auto scale : scales) {
+                heat_method.scale(scale);
+                heat_method.compute(sources[0], geodesics);
+            }
+        }
+    }
+}
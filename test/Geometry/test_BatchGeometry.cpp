@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Geometry/BatchGeometry.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/IO/PlyIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Point_3 = typename Kernel::Point_3;
+using Mesh = CGAL::Surface_mesh<Point_3>;
+
+TEST_CASE("Geometry, BatchGeometry", "[geometry][batchgeometry]")
+{
+    std::vector<Mesh> meshes(2);
+    {
+        std::string fbumpy(DATA_DIR);
+        fbumpy.append("bumpy.off");
+        std::vector<double> positions;
+        std::vector<int> indices;
+        Euclid::read_off<3>(fbumpy, positions, nullptr, &indices, nullptr);
+        Euclid::make_mesh<3>(meshes[0], positions, indices);
+    }
+    {
+        std::string fcube(DATA_DIR);
+        fcube.append("cube_ascii.ply");
+        std::vector<double> positions;
+        std::vector<int> indices;
+        Euclid::read_ply<3>(
+            fcube, positions, nullptr, nullptr, &indices, nullptr);
+        Euclid::make_mesh<3>(meshes[1], positions, indices);
+    }
+
+    Euclid::BatchQuantities quantities;
+    quantities.face_normals = true;
+    quantities.face_areas = true;
+    quantities.curvatures = true;
+    quantities.cotangent_matrix = true;
+    quantities.mass_matrix = true;
+    quantities.graph_laplacian = true;
+    auto results =
+        Euclid::batch_geometry(meshes.begin(), meshes.end(), quantities);
+    REQUIRE(results.size() == meshes.size());
+
+    for (size_t m = 0; m < meshes.size(); ++m) {
+        const auto& mesh = meshes[m];
+        const auto& result = results[m];
+        const int nv = num_vertices(mesh);
+        const auto nf = num_faces(mesh);
+
+        auto normals = Euclid::face_normals(mesh);
+        auto areas = Euclid::face_areas(mesh);
+        REQUIRE(result.face_normals.size() == 3 * nf);
+        REQUIRE(result.face_areas.size() == nf);
+        for (size_t i = 0; i < nf; ++i) {
+            REQUIRE(result.face_normals[3 * i + 0] ==
+                    Approx(normals[i].x()).margin(1e-8));
+            REQUIRE(result.face_normals[3 * i + 1] ==
+                    Approx(normals[i].y()).margin(1e-8));
+            REQUIRE(result.face_normals[3 * i + 2] ==
+                    Approx(normals[i].z()).margin(1e-8));
+            REQUIRE(result.face_areas[i] == Approx(areas[i]));
+        }
+
+        auto mean = Euclid::mean_curvatures(mesh);
+        REQUIRE(result.curvatures.mean.size() == nv);
+        REQUIRE(result.curvatures.d_max.size() == 0);
+        for (int i = 0; i < nv; ++i) {
+            REQUIRE(result.curvatures.mean(i) == Approx(mean[i]));
+        }
+
+        auto cotangent = Euclid::cotangent_matrix(mesh);
+        REQUIRE((result.cotangent_matrix - cotangent).norm() ==
+                Approx(0.0).margin(1e-8 * cotangent.norm()));
+
+        auto mass = Euclid::mass_matrix(mesh);
+        REQUIRE((result.mass_matrix - mass).norm() ==
+                Approx(0.0).margin(1e-8 * mass.norm()));
+
+        Eigen::SparseMatrix<double> adjacency, degree;
+        std::tie(adjacency, degree) = Euclid::adjacency_matrix(mesh);
+        Eigen::SparseMatrix<double> graph = degree - adjacency;
+        REQUIRE((result.graph_laplacian - graph).norm() == 0.0);
+    }
+
+    SECTION("partial request")
+    {
+        Euclid::BatchQuantities areas_only;
+        areas_only.face_areas = true;
+        auto partial =
+            Euclid::batch_geometry(meshes.begin(), meshes.end(), areas_only);
+        REQUIRE(partial[0].face_areas == results[0].face_areas);
+        REQUIRE(partial[0].face_normals.empty());
+        REQUIRE(partial[0].cotangent_matrix.nonZeros() == 0);
+        REQUIRE(partial[0].graph_laplacian.nonZeros() == 0);
+    }
+}
+
+TEST_CASE("Geometry, BatchGeometry benchmark",
+          "[.benchmark][geometry][batchgeometry]")
+{
+    std::string fbumpy(DATA_DIR);
+    fbumpy.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_off<3>(fbumpy, positions, nullptr, &indices, nullptr);
+
+    // Throughput in meshes per second is 1000 over the reported time
+    std::vector<Mesh> meshes(1000);
+    for (auto& mesh : meshes) {
+        Euclid::make_mesh<3>(mesh, positions, indices);
+    }
+    Euclid::BatchQuantities quantities;
+    quantities.face_normals = true;
+    quantities.face_areas = true;
+    quantities.curvatures = true;
+    quantities.cotangent_matrix = true;
+    quantities.mass_matrix = true;
+
+    BENCHMARK("1000 meshes, one by one")
+    {
+        for (const auto& mesh : meshes) {
+            auto normals = Euclid::face_normals(mesh);
+            auto areas = Euclid::face_areas(mesh);
+            auto curvatures = Euclid::principal_curvatures(mesh, false);
+            auto cotangent = Euclid::cotangent_matrix(mesh);
+            auto mass = Euclid::mass_matrix(mesh);
+        }
+    }
+
+    BENCHMARK("1000 meshes, batched")
+    {
+        auto results =
+            Euclid::batch_geometry(meshes.begin(), meshes.end(), quantities);
+    }
+}
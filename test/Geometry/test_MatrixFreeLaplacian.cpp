@@ -0,0 +1,133 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Geometry/MatrixFreeLaplacian.h>
+
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCholesky>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/IO/PlyIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Point_3 = typename Kernel::Point_3;
+using Mesh = CGAL::Surface_mesh<Point_3>;
+
+TEST_CASE("Geometry, MatrixFreeLaplacian", "[geometry][matrixfreelaplacian]")
+{
+    std::string fbumpy(DATA_DIR);
+    fbumpy.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_off<3>(fbumpy, positions, nullptr, &indices, nullptr);
+    Mesh bumpy;
+    Euclid::make_mesh<3>(bumpy, positions, indices);
+    const int nv = num_vertices(bumpy);
+
+    Euclid::MatrixFreeLaplacian<double> laplacian;
+    laplacian.build(positions, indices);
+    auto cotangent = Euclid::cotangent_matrix(bumpy);
+
+    SECTION("product")
+    {
+        REQUIRE(laplacian.rows() == nv);
+        REQUIRE(laplacian.cols() == nv);
+
+        Eigen::MatrixXd x = Eigen::MatrixXd::Random(nv, 3);
+        Eigen::MatrixXd y1 = laplacian * x;
+        Eigen::MatrixXd y2 = cotangent * x;
+        REQUIRE((y1 - y2).norm() == Approx(0.0).margin(1e-8 * y2.norm()));
+
+        Eigen::VectorXd y3(nv);
+        laplacian.perform_op(x.col(0).data(), y3.data());
+        REQUIRE((y3 - y2.col(0)).norm() ==
+                Approx(0.0).margin(1e-8 * y2.norm()));
+
+        Eigen::VectorXd d1 = laplacian.diagonal();
+        Eigen::VectorXd d2 = cotangent.diagonal();
+        REQUIRE((d1 - d2).norm() == Approx(0.0).margin(1e-8 * d2.norm()));
+    }
+
+    SECTION("conjugate gradient")
+    {
+        const double t = 0.01;
+        Eigen::SparseMatrix<double> mass = Euclid::mass_matrix(bumpy);
+        Eigen::VectorXd d = mass.diagonal() / t;
+        laplacian.set_diagonal(d);
+        Eigen::SparseMatrix<double> heat = cotangent;
+        heat.diagonal() += d;
+
+        Eigen::VectorXd x0 = Eigen::VectorXd::Random(nv);
+        Eigen::VectorXd b = heat * x0;
+        Eigen::ConjugateGradient<Euclid::MatrixFreeLaplacian<double>,
+                                 Eigen::Lower | Eigen::Upper,
+                                 Eigen::IdentityPreconditioner>
+            solver;
+        solver.setTolerance(1e-10);
+        solver.compute(laplacian);
+        Eigen::VectorXd x = solver.solve(b);
+        REQUIRE(solver.info() == Eigen::Success);
+        REQUIRE((x - x0).norm() == Approx(0.0).margin(1e-6 * x0.norm()));
+
+        laplacian.set_diagonal(Eigen::VectorXd());
+        REQUIRE((laplacian.diagonal() - cotangent.diagonal()).norm() ==
+                Approx(0.0).margin(1e-8 * cotangent.norm()));
+    }
+}
+
+TEST_CASE("Geometry, MatrixFreeLaplacian benchmark",
+          "[.benchmark][geometry][matrixfreelaplacian]")
+{
+    std::string fdragon(DATA_DIR);
+    fdragon.append("dragon.ply");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_ply<3>(
+        fdragon, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh dragon;
+    Euclid::make_mesh<3>(dragon, positions, indices);
+    const int nv = num_vertices(dragon);
+    const double t = 1e-4;
+
+    Euclid::MatrixFreeLaplacian<double> laplacian;
+    laplacian.build(positions, indices);
+    auto cotangent = Euclid::cotangent_matrix(dragon);
+    Eigen::SparseMatrix<double> mass = Euclid::mass_matrix(dragon);
+    Eigen::VectorXd d = mass.diagonal() / t;
+    Eigen::SparseMatrix<double> heat = cotangent;
+    heat.diagonal() += d;
+    Eigen::VectorXd x = Eigen::VectorXd::Random(nv);
+    Eigen::VectorXd y(nv);
+
+    BENCHMARK("product, assembled")
+    {
+        y.noalias() = cotangent * x;
+    }
+
+    BENCHMARK("product, matrix-free")
+    {
+        y.noalias() = laplacian * x;
+    }
+
+    BENCHMARK("heat solve, assembled Cholesky")
+    {
+        Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver(heat);
+        y = solver.solve(x);
+    }
+
+    laplacian.set_diagonal(d);
+    BENCHMARK("heat solve, matrix-free conjugate gradient")
+    {
+        Eigen::ConjugateGradient<Euclid::MatrixFreeLaplacian<double>,
+                                 Eigen::Lower | Eigen::Upper,
+                                 Eigen::IdentityPreconditioner>
+            solver(laplacian);
+        y = solver.solve(x);
+    }
+}
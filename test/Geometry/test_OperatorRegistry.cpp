@@ -0,0 +1,149 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Geometry/OperatorRegistry.h>
+
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Eigen/SparseCore>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Point_3 = typename Kernel::Point_3;
+using Mesh = CGAL::Surface_mesh<Point_3>;
+
+TEST_CASE("Geometry, OperatorRegistry", "[geometry][operatorregistry]")
+{
+    std::string fbumpy(DATA_DIR);
+    fbumpy.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_off<3>(fbumpy, positions, nullptr, &indices, nullptr);
+    Mesh bumpy;
+    Euclid::make_mesh<3>(bumpy, positions, indices);
+    const int nv = num_vertices(bumpy);
+    const int ne = num_edges(bumpy);
+
+    Euclid::OperatorRegistry<Mesh> ops;
+    ops.build(bumpy);
+
+    SECTION("pattern")
+    {
+        REQUIRE(ops.size() == nv);
+        REQUIRE(ops.nonzeros() == nv + 2 * ne);
+        for (int i = 0; i < nv; ++i) {
+            REQUIRE(ops.index(i, i) >= 0);
+        }
+        auto i = indices[0];
+        auto j = indices[1];
+        REQUIRE(ops.index(i, j) >= 0);
+        REQUIRE(ops.index(j, i) >= 0);
+    }
+
+    SECTION("graph Laplacian")
+    {
+        auto [adj, degree] = Euclid::adjacency_matrix(bumpy);
+        Eigen::SparseMatrix<double> laplacian = degree - adj;
+        auto view = ops.view(ops.graph_laplacian());
+        REQUIRE(view.nonZeros() == laplacian.nonZeros());
+        REQUIRE((view - laplacian).norm() == Approx(0.0).margin(1e-12));
+        REQUIRE((ops.view(ops.degree()) - degree).norm() ==
+                Approx(0.0).margin(1e-12));
+    }
+
+    SECTION("cotangent Laplacian")
+    {
+        auto cotangent = Euclid::cotangent_matrix(bumpy);
+        auto view = ops.view(ops.cotangent_laplacian());
+        REQUIRE((view - cotangent).norm() ==
+                Approx(0.0).margin(1e-8 * cotangent.norm()));
+    }
+
+    SECTION("mass matrix")
+    {
+        auto mass = Euclid::mass_matrix(bumpy);
+        auto d = ops.diagonal(ops.mass());
+        REQUIRE(d.size() == nv);
+        for (int i = 0; i < nv; ++i) {
+            REQUIRE(d(i) == Approx(mass.coeff(i, i)));
+        }
+    }
+
+    SECTION("combined operators")
+    {
+        const double t = 0.01;
+        Eigen::SparseMatrix<double> heat =
+            Euclid::mass_matrix(bumpy) + t * Euclid::cotangent_matrix(bumpy);
+        REQUIRE((ops.matrix(ops.heat(t)) - heat).norm() ==
+                Approx(0.0).margin(1e-8 * heat.norm()));
+
+        Eigen::VectorXd b = ops.diagonal(ops.mass()).cwiseInverse().cwiseSqrt();
+        Eigen::SparseMatrix<double> B(b.asDiagonal());
+        Eigen::SparseMatrix<double> scaled =
+            B * Euclid::cotangent_matrix(bumpy) * B;
+        REQUIRE((ops.view(ops.scale(ops.cotangent_laplacian(), b)) - scaled)
+                    .norm() == Approx(0.0).margin(1e-8 * scaled.norm()));
+    }
+}
+
+TEST_CASE("Geometry, OperatorRegistry on an open mesh",
+          "[geometry][operatorregistry]")
+{
+    // A single right triangle, whose edges are all on the border
+    std::vector<double> positions{
+        0.0, 0.0, 0.0, 1.0, 0.0, 0.0, 0.0, 1.0, 0.0
+    };
+    std::vector<int> indices{ 0, 1, 2 };
+    Mesh triangle;
+    Euclid::make_mesh<3>(triangle, positions, indices);
+
+    SECTION("border edges")
+    {
+        // The legs are opposite to 45 degrees, the hypotenuse to 90 degrees
+        auto cotangent = Euclid::cotangent_matrix(triangle);
+        REQUIRE(cotangent.coeff(0, 1) == Approx(-0.5));
+        REQUIRE(cotangent.coeff(0, 2) == Approx(-0.5));
+        REQUIRE(cotangent.coeff(1, 2) == Approx(0.0).margin(1e-12));
+        REQUIRE(cotangent.coeff(0, 0) == Approx(1.0));
+
+        Euclid::OperatorRegistry<Mesh> ops;
+        ops.build(triangle);
+        REQUIRE((ops.view(ops.cotangent_laplacian()) - cotangent).norm() ==
+                Approx(0.0).margin(1e-12));
+    }
+
+    SECTION("grid")
+    {
+        // A bent grid, so that the cotangents differ among the edges
+        const int n = 6;
+        positions.clear();
+        indices.clear();
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                positions.push_back(i);
+                positions.push_back(j * 1.3);
+                positions.push_back(0.1 * i * j);
+            }
+        }
+        for (int i = 0; i + 1 < n; ++i) {
+            for (int j = 0; j + 1 < n; ++j) {
+                int v = i * n + j;
+                indices.insert(indices.end(), { v, v + n, v + n + 1 });
+                indices.insert(indices.end(), { v, v + n + 1, v + 1 });
+            }
+        }
+        Mesh grid;
+        Euclid::make_mesh<3>(grid, positions, indices);
+
+        Euclid::OperatorRegistry<Mesh> ops;
+        ops.build(grid);
+        auto cotangent = Euclid::cotangent_matrix(grid);
+        REQUIRE((ops.view(ops.cotangent_laplacian()) - cotangent).norm() ==
+                Approx(0.0).margin(1e-8 * cotangent.norm()));
+    }
+}
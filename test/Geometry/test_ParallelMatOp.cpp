@@ -0,0 +1,161 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Geometry/ParallelMatOp.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/IO/PlyIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+#include <Spectra/MatOp/SparseSymMatProd.h>
+#include <Spectra/MatOp/SparseSymShiftSolve.h>
+#include <Spectra/SymEigsShiftSolver.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Point_3 = typename Kernel::Point_3;
+using Mesh = CGAL::Surface_mesh<Point_3>;
+
+TEST_CASE("Geometry, ParallelMatOp", "[geometry][parallelmatop]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+    const int nv = num_vertices(mesh);
+
+    Eigen::SparseMatrix<double> L = Euclid::cotangent_matrix(mesh);
+    Eigen::VectorXd x = Eigen::VectorXd::Random(nv);
+    Eigen::VectorXd y1(nv), y2(nv);
+
+    SECTION("product")
+    {
+        Euclid::ParallelSymMatProd<double> op1(L);
+        Spectra::SparseSymMatProd<double> op2(L);
+        REQUIRE(op1.rows() == nv);
+        REQUIRE(op1.cols() == nv);
+        op1.perform_op(x.data(), y1.data());
+        op2.perform_op(x.data(), y2.data());
+        REQUIRE((y1 - y2).norm() == Approx(0.0).margin(1e-10 * y2.norm()));
+    }
+
+    SECTION("shift solve")
+    {
+        const double sigma = -0.5;
+        Euclid::ParallelSymShiftSolve<double> op(L);
+        REQUIRE(op.rows() == nv);
+        REQUIRE(op.cols() == nv);
+        op.set_shift(sigma);
+        op.perform_op(x.data(), y1.data());
+
+        Eigen::SparseMatrix<double> identity(nv, nv);
+        identity.setIdentity();
+        Eigen::VectorXd r = (L - sigma * identity) * y1 - x;
+        REQUIRE(r.norm() == Approx(0.0).margin(1e-8 * x.norm()));
+    }
+
+    SECTION("eigen solver")
+    {
+        const int k = 10;
+        const int convergence = 2 * k + 1;
+        Spectra::SparseSymShiftSolve<double> op1(L);
+        Spectra::SymEigsShiftSolver<double,
+                                    Spectra::LARGEST_MAGN,
+                                    Spectra::SparseSymShiftSolve<double>>
+            eigensolver1(&op1, k, convergence, -0.5);
+        eigensolver1.init();
+        eigensolver1.compute(1000, 1e-10, Spectra::SMALLEST_MAGN);
+        REQUIRE(eigensolver1.info() == Spectra::SUCCESSFUL);
+
+        Euclid::ParallelSymShiftSolve<double> op2(L);
+        Spectra::SymEigsShiftSolver<double,
+                                    Spectra::LARGEST_MAGN,
+                                    Euclid::ParallelSymShiftSolve<double>>
+            eigensolver2(&op2, k, convergence, -0.5);
+        eigensolver2.init();
+        eigensolver2.compute(1000, 1e-10, Spectra::SMALLEST_MAGN);
+        REQUIRE(eigensolver2.info() == Spectra::SUCCESSFUL);
+
+        Eigen::VectorXd lambdas1 = eigensolver1.eigenvalues();
+        Eigen::VectorXd lambdas2 = eigensolver2.eigenvalues();
+        for (int i = 0; i < k; ++i) {
+            REQUIRE(lambdas2(i) ==
+                    Approx(lambdas1(i)).margin(1e-8 * lambdas1.norm()));
+        }
+    }
+}
+
+TEST_CASE("Geometry, ParallelMatOp benchmark",
+          "[.benchmark][geometry][parallelmatop]")
+{
+    std::string fdragon(DATA_DIR);
+    fdragon.append("dragon.ply");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_ply<3>(
+        fdragon, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh dragon;
+    Euclid::make_mesh<3>(dragon, positions, indices);
+    const int nv = num_vertices(dragon);
+    const int k = 300;
+    const int convergence = std::min(2 * k + 1, nv);
+
+    Eigen::SparseMatrix<double> L = Euclid::cotangent_matrix(dragon);
+    Eigen::SparseMatrix<double> mass = Euclid::mass_matrix(dragon);
+    Eigen::SparseMatrix<double> B = mass.unaryExpr(
+        [](double v) { return v == 0 ? 0 : 1 / std::sqrt(v); });
+    L = (B * L * B).eval();
+    Eigen::VectorXd x = Eigen::VectorXd::Random(nv);
+    Eigen::VectorXd y(nv);
+
+    // A Lanczos basis of the eigen solvers takes one operation per vector
+    BENCHMARK("2k + 1 shift solves, Spectra operation")
+    {
+        Spectra::SparseSymShiftSolve<double> op(L);
+        op.set_shift(0.0);
+        for (int i = 0; i < convergence; ++i) {
+            op.perform_op(x.data(), y.data());
+        }
+    }
+
+    BENCHMARK("2k + 1 shift solves, Euclid operation")
+    {
+        Euclid::ParallelSymShiftSolve<double> op(L);
+        op.set_shift(0.0);
+        for (int i = 0; i < convergence; ++i) {
+            op.perform_op(x.data(), y.data());
+        }
+    }
+
+    BENCHMARK("k = 300, Spectra operations")
+    {
+        Spectra::SparseSymShiftSolve<double> op(L);
+        Spectra::SymEigsShiftSolver<double,
+                                    Spectra::LARGEST_MAGN,
+                                    Spectra::SparseSymShiftSolve<double>>
+            eigensolver(&op, k, convergence, 0.0);
+        eigensolver.init();
+        eigensolver.compute(1000, 1e-10, Spectra::SMALLEST_MAGN);
+    }
+
+    BENCHMARK("k = 300, Euclid operations")
+    {
+        Euclid::ParallelSymShiftSolve<double> op(L);
+        Spectra::SymEigsShiftSolver<double,
+                                    Spectra::LARGEST_MAGN,
+                                    Euclid::ParallelSymShiftSolve<double>>
+            eigensolver(&op, k, convergence, 0.0);
+        eigensolver.init();
+        eigensolver.compute(1000, 1e-10, Spectra::SMALLEST_MAGN);
+    }
+}
@@ -8,8 +8,11 @@
 #include <CGAL/Simple_cartesian.h>
 #include <CGAL/Surface_mesh.h>
 #include <Eigen/Core>
+#include <Eigen/Eigenvalues>
+#include <Euclid/Geometry/TriMeshGeometry.h>
 #include <Euclid/MeshUtil/MeshHelpers.h>
 #include <Euclid/IO/OffIO.h>
+#include <Euclid/IO/PlyIO.h>
 
 #include <config.h>
 
@@ -93,4 +96,175 @@ TEST_CASE("Geometry, Spectral", "[geometry][spectral]")
         REQUIRE(phis1.col(0).normalized().norm() == Approx(norm));
         REQUIRE(phis2.col(0).normalized().norm() == Approx(norm));
     }
+
+    SECTION("LOBPCG")
+    {
+        Eigen::VectorXd lambdas1, lambdas2, lambdas3;
+        Eigen::MatrixXd phis1, phis2, phis3;
+
+        auto n1 = Euclid::spectrum(mesh,
+                                   k,
+                                   lambdas1,
+                                   phis1,
+                                   Euclid::SpecOp::laplace_beltrami,
+                                   Euclid::SpecDecomp::symmetric);
+        auto n2 = Euclid::spectrum(mesh,
+                                   k,
+                                   lambdas2,
+                                   phis2,
+                                   Euclid::SpecOp::laplace_beltrami,
+                                   Euclid::SpecDecomp::lobpcg);
+
+        REQUIRE(n1 == k);
+        REQUIRE(n2 == k);
+        for (unsigned i = 1; i < k; ++i) {
+            REQUIRE(lambdas2(i) == Approx(lambdas1(i)).epsilon(1e-6));
+        }
+        REQUIRE(phis2.rows() == nv);
+        REQUIRE(phis2.cols() == k);
+        REQUIRE(phis2.col(0).normalized().norm() == Approx(norm));
+
+        // warm start from the spectrum of a slightly deformed mesh
+        Mesh deformed = mesh;
+        for (auto v : vertices(deformed)) {
+            auto& p = deformed.point(v);
+            p = Point_3(p.x() * 1.01, p.y(), p.z());
+        }
+        auto n3 = Euclid::spectrum(deformed,
+                                   k,
+                                   lambdas3,
+                                   phis3,
+                                   phis2,
+                                   Euclid::SpecOp::laplace_beltrami,
+                                   20);
+        REQUIRE(n3 == k);
+        REQUIRE(lambdas3(k - 1) == Approx(lambdas2(k - 1)).epsilon(0.05));
+    }
+
+    SECTION("multilevel")
+    {
+        Eigen::VectorXd lambdas1, lambdas2, errors;
+        Eigen::MatrixXd phis1, phis2;
+
+        Euclid::spectrum(mesh, k, lambdas1, phis1);
+        auto n = Euclid::multilevel_spectrum(mesh,
+                                             k,
+                                             lambdas2,
+                                             phis2,
+                                             errors,
+                                             Euclid::SpecOp::laplace_beltrami,
+                                             100);
+
+        REQUIRE(n == k);
+        REQUIRE(errors.size() == k);
+        REQUIRE(phis2.rows() == nv);
+        REQUIRE(phis2.cols() == k);
+        REQUIRE(errors.minCoeff() >= 0.0);
+        REQUIRE(lambdas2(0) == Approx(0.0).margin(1e-8));
+        REQUIRE(lambdas2(k - 1) == Approx(lambdas1(k - 1)).epsilon(0.2));
+
+        // Each approximation is within its error bound of an exact eigenvalue,
+        // up to the tolerance of the exact solver
+        for (unsigned i = 0; i < k; ++i) {
+            auto distance = (lambdas1.array() - lambdas2(i)).abs().minCoeff();
+            REQUIRE(distance <= errors(i) + 1e-6);
+        }
+
+        // A larger coarsest level gives tighter bounds
+        Eigen::VectorXd lambdas3, errors3;
+        Eigen::MatrixXd phis3;
+        Euclid::multilevel_spectrum(mesh,
+                                    k,
+                                    lambdas3,
+                                    phis3,
+                                    errors3,
+                                    Euclid::SpecOp::laplace_beltrami,
+                                    400);
+        REQUIRE(errors3.maxCoeff() < errors.maxCoeff());
+        REQUIRE(errors3.sum() < errors.sum());
+    }
+}
+
+TEST_CASE("Geometry, Spectral on an open mesh", "[geometry][spectral]")
+{
+    // A bent grid, whose border edges only have one incident face
+    const int n = 12;
+    std::vector<double> positions;
+    std::vector<int> indices;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            positions.push_back(i);
+            positions.push_back(j * 1.3);
+            positions.push_back(0.1 * i * j);
+        }
+    }
+    for (int i = 0; i + 1 < n; ++i) {
+        for (int j = 0; j + 1 < n; ++j) {
+            int v = i * n + j;
+            indices.insert(indices.end(), { v, v + n, v + n + 1 });
+            indices.insert(indices.end(), { v, v + n + 1, v + 1 });
+        }
+    }
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+
+    // The spectrum agrees with the dense solution of the cotangent matrix
+    const unsigned k = 10;
+    Eigen::VectorXd lambdas;
+    Eigen::MatrixXd phis;
+    auto nconv = Euclid::spectrum(mesh, k, lambdas, phis);
+    REQUIRE(nconv == k);
+
+    Eigen::MatrixXd cotangent = Euclid::cotangent_matrix(mesh);
+    Eigen::MatrixXd mass = Euclid::mass_matrix(mesh);
+    Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXd> solver(cotangent,
+                                                                    mass);
+    const auto& expected = solver.eigenvalues();
+    REQUIRE(lambdas(0) == Approx(0.0).margin(1e-8));
+    for (unsigned i = 1; i < k; ++i) {
+        REQUIRE(lambdas(i) == Approx(expected(i)).epsilon(1e-6));
+    }
+}
+
+TEST_CASE("Geometry, Spectral benchmark", "[.benchmark][geometry][spectral]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("dragon.ply");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_ply<3>(fin, positions, nullptr, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+    const unsigned k = 100;
+
+    Eigen::VectorXd lambdas;
+    Eigen::MatrixXd phis;
+    BENCHMARK("Lanczos")
+    {
+        Euclid::spectrum(mesh, k, lambdas, phis);
+    }
+    BENCHMARK("LOBPCG")
+    {
+        Euclid::spectrum(mesh,
+                         k,
+                         lambdas,
+                         phis,
+                         Euclid::SpecOp::laplace_beltrami,
+                         Euclid::SpecDecomp::lobpcg);
+    }
+    BENCHMARK("Multilevel")
+    {
+        Euclid::spectrum(mesh,
+                         k,
+                         lambdas,
+                         phis,
+                         Euclid::SpecOp::laplace_beltrami,
+                         Euclid::SpecDecomp::multilevel);
+    }
+    Euclid::spectrum(mesh, k, lambdas, phis);
+    Eigen::MatrixXd initial = phis;
+    BENCHMARK("LOBPCG, warm start")
+    {
+        Euclid::spectrum(mesh, k, lambdas, phis, initial);
+    }
 }
@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Geometry/SpectrumCache.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Point_3 = typename Kernel::Point_3;
+using Mesh = CGAL::Surface_mesh<Point_3>;
+
+TEST_CASE("Geometry, SpectrumCache", "[geometry][spectrumcache]")
+{
+    std::string fin(DATA_DIR);
+    fin.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<int> indices;
+    Euclid::read_off<3>(fin, positions, nullptr, &indices, nullptr);
+    Mesh mesh;
+    Euclid::make_mesh<3>(mesh, positions, indices);
+    const int nv = num_vertices(mesh);
+
+    Euclid::SpectrumCache cache(TMP_DIR);
+    const auto op = Euclid::SpecOp::laplace_beltrami;
+    const auto decomp = Euclid::SpecDecomp::symmetric;
+    auto file = cache.path(mesh, op, decomp);
+    std::remove(file.c_str());
+
+    SECTION("key")
+    {
+        REQUIRE(cache.hash(mesh, op, decomp) ==
+                cache.hash(mesh, op, decomp));
+        REQUIRE(cache.hash(mesh, op, decomp) !=
+                cache.hash(mesh, Euclid::SpecOp::graph_laplacian, decomp));
+        REQUIRE(cache.hash(mesh, op, decomp) !=
+                cache.hash(mesh, op, Euclid::SpecDecomp::generalized));
+
+        Mesh moved;
+        positions[0] += 1e-3;
+        Euclid::make_mesh<3>(moved, positions, indices);
+        REQUIRE(cache.hash(mesh, op, decomp) != cache.hash(moved, op, decomp));
+    }
+
+    SECTION("store and map")
+    {
+        Eigen::VectorXd lambdas1, lambdas2;
+        Eigen::MatrixXd phis1, phis2;
+        auto n1 = cache.spectrum(mesh, 10, lambdas1, phis1, op, decomp);
+        REQUIRE(n1 == 10);
+        REQUIRE(std::ifstream(file).good());
+
+        Euclid::MappedSpectrum<double> mapped(file);
+        REQUIRE(mapped.hash() == cache.hash(mesh, op, decomp));
+        REQUIRE(mapped.size() == 10);
+        REQUIRE(mapped.eigenvalues() == lambdas1);
+        REQUIRE(mapped.eigenfunctions() == phis1);
+
+        // Fewer eigenpairs are served from the cache
+        auto n2 = cache.spectrum(mesh, 5, lambdas2, phis2, op, decomp);
+        REQUIRE(n2 == 5);
+        REQUIRE(lambdas2 == lambdas1.head(5));
+        REQUIRE(phis2 == phis1.leftCols(5));
+    }
+
+    SECTION("corrupted entry")
+    {
+        std::ofstream(file) << "not a spectrum";
+        Eigen::VectorXd lambdas, lambdas_ref;
+        Eigen::MatrixXd phis, phis_ref;
+        auto n = cache.spectrum(mesh, 10, lambdas, phis, op, decomp);
+        Euclid::spectrum(mesh, 10, lambdas_ref, phis_ref, op, decomp);
+
+        REQUIRE(n == 10);
+        for (unsigned i = 1; i < n; ++i) {
+            REQUIRE(lambdas(i) == Approx(lambdas_ref(i)).epsilon(1e-4));
+        }
+        REQUIRE(Euclid::MappedSpectrum<double>(file).size() == 10);
+    }
+
+    SECTION("warm start")
+    {
+        const unsigned k = 20;
+        Eigen::VectorXd lambdas, lambdas_ref;
+        Eigen::MatrixXd phis, phis_ref;
+        cache.spectrum(mesh, 10, lambdas, phis, op, decomp);
+        auto n = cache.spectrum(mesh, k, lambdas, phis, op, decomp);
+        Euclid::spectrum(mesh, k, lambdas_ref, phis_ref, op, decomp);
+
+        REQUIRE(n == k);
+        REQUIRE(phis.rows() == nv);
+        REQUIRE(phis.cols() == k);
+        for (unsigned i = 1; i < k; ++i) {
+            REQUIRE(lambdas(i) == Approx(lambdas_ref(i)).epsilon(1e-4));
+        }
+
+        // Cached and new eigenfunctions are orthonormal w.r.t. the mass
+        Eigen::SparseMatrix<double> mass = Euclid::mass_matrix(mesh);
+        Eigen::MatrixXd gram = phis.transpose() * mass * phis;
+        REQUIRE((gram - Eigen::MatrixXd::Identity(k, k)).norm() ==
+                Approx(0.0).margin(1e-6));
+        REQUIRE(Euclid::MappedSpectrum<double>(file).size() == k);
+    }
+
+    std::remove(file.c_str());
+}
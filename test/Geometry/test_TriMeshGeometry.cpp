@@ -1,6 +1,7 @@
 #include <catch2/catch.hpp>
 #include <Euclid/Geometry/TriMeshGeometry.h>
 
+#include <cmath>
 #include <string>
 #include <vector>
 
@@ -12,6 +13,7 @@
 #include <Euclid/IO/OffIO.h>
 #include <Euclid/IO/PlyIO.h>
 #include <Euclid/MeshUtil/MeshHelpers.h>
+#include <Euclid/MeshUtil/PrimitiveGenerator.h>
 #include <Euclid/Util/Color.h>
 #include <igl/invert_diag.h>
 
@@ -328,4 +330,61 @@ TEST_CASE("Geometry, TriMeshGeometry", "[geometry][trimeshgeometry]")
         Euclid::write_ply<3>(
             fout, bpositions, nullptr, nullptr, &bindices, &mean_curvatures);
     }
+
+    SECTION("principal curvatures")
+    {
+        auto curvatures = Euclid::principal_curvatures(bumpy);
+        auto gaussian = Euclid::gaussian_curvatures(bumpy);
+        auto mean = Euclid::mean_curvatures(bumpy);
+        const auto nv = static_cast<int>(num_vertices(bumpy));
+        REQUIRE(curvatures.mean.size() == nv);
+        REQUIRE(curvatures.d_max.rows() == nv);
+        REQUIRE(mean.size() == num_vertices(bumpy));
+
+        // The magnitude of the mean curvature normal, computed independently
+        // from the cotangent and mass matrices
+        auto laplacian = Euclid::cotangent_matrix(bumpy);
+        auto mass = Euclid::mass_matrix(bumpy);
+        Eigen::SparseMatrix<float> inv_mass;
+        igl::invert_diag(mass, inv_mass);
+        Eigen::MatrixXf hn = inv_mass * laplacian * bumpy_v;
+        Eigen::VectorXf reference = 0.5f * hn.rowwise().norm();
+        const auto margin = 1e-4f * reference.maxCoeff();
+
+        for (int i = 0; i < nv; ++i) {
+            REQUIRE(std::abs(mean[i]) ==
+                    Approx(reference(i)).epsilon(1e-3).margin(margin));
+            REQUIRE(std::abs(curvatures.mean(i)) ==
+                    Approx(reference(i)).epsilon(1e-3).margin(margin));
+            REQUIRE(curvatures.gaussian(i) ==
+                    Approx(gaussian[i]).epsilon(1e-3).margin(1e-3));
+            REQUIRE(curvatures.k_max(i) >= curvatures.k_min(i));
+            REQUIRE(curvatures.d_max.row(i).norm() ==
+                    Approx(1.0f).margin(1e-3));
+            REQUIRE(curvatures.d_max.row(i).dot(curvatures.d_min.row(i)) ==
+                    Approx(0.0f).margin(1e-3));
+        }
+
+        std::vector<uint8_t> colors;
+        Euclid::colormap(igl::COLOR_MAP_TYPE_JET, mean, colors, true);
+        std::string fout(TMP_DIR);
+        fout.append("bumpy_mean_curvature.ply");
+        Euclid::write_ply<3>(
+            fout, bpositions, nullptr, nullptr, &bindices, &colors);
+    }
+
+    SECTION("principal curvatures of a sphere")
+    {
+        // Every curvature of a sphere of radius 2 is 1/2, the mean one being
+        // positive as the sphere is convex
+        Mesh sphere;
+        Euclid::make_subdivision_sphere(sphere, Point_3(0, 0, 0), 2.0f);
+        auto curvatures = Euclid::principal_curvatures(sphere, false);
+        for (int i = 0; i < static_cast<int>(num_vertices(sphere)); ++i) {
+            REQUIRE(curvatures.mean(i) == Approx(0.5f).epsilon(0.05));
+            REQUIRE(curvatures.gaussian(i) == Approx(0.25f).epsilon(0.1));
+            REQUIRE(curvatures.k_max(i) == Approx(0.5f).epsilon(0.15));
+            REQUIRE(curvatures.k_min(i) == Approx(0.5f).epsilon(0.15));
+        }
+    }
 }
@@ -0,0 +1,158 @@
+#include <catch2/catch.hpp>
+#include <Euclid/Geometry/TriMeshKernels.h>
+
+#include <string>
+#include <vector>
+
+#include <CGAL/Simple_cartesian.h>
+#include <CGAL/Surface_mesh.h>
+#include <Euclid/Geometry/TriMeshGeometry.h>
+#include <Euclid/IO/OffIO.h>
+#include <Euclid/IO/PlyIO.h>
+#include <Euclid/Math/Vector.h>
+#include <Euclid/MeshUtil/MeshHelpers.h>
+
+#include <config.h>
+
+using Kernel = CGAL::Simple_cartesian<double>;
+using Point_3 = typename Kernel::Point_3;
+using Mesh = CGAL::Surface_mesh<Point_3>;
+
+TEST_CASE("Geometry, TriMeshKernels", "[geometry][trimeshkernels]")
+{
+    std::string fbumpy(DATA_DIR);
+    fbumpy.append("bumpy.off");
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    Euclid::read_off<3>(fbumpy, positions, nullptr, &indices, nullptr);
+    Mesh bumpy;
+    Euclid::make_mesh<3>(bumpy, positions, indices);
+    const auto nf = indices.size() / 3;
+
+    SECTION("face normals")
+    {
+        std::vector<double> normals;
+        Euclid::face_normals(positions, indices, normals);
+        auto fnormals = Euclid::face_normals(bumpy);
+        REQUIRE(normals.size() == nf * 3);
+        for (size_t i = 0; i < nf; ++i) {
+            REQUIRE(normals[3 * i + 0] ==
+                    Approx(fnormals[i].x()).margin(1e-8));
+            REQUIRE(normals[3 * i + 1] ==
+                    Approx(fnormals[i].y()).margin(1e-8));
+            REQUIRE(normals[3 * i + 2] ==
+                    Approx(fnormals[i].z()).margin(1e-8));
+        }
+    }
+
+    SECTION("face areas")
+    {
+        std::vector<double> areas;
+        Euclid::face_areas(positions, indices, areas);
+        auto fareas = Euclid::face_areas(bumpy);
+        REQUIRE(areas.size() == nf);
+        for (size_t i = 0; i < nf; ++i) {
+            REQUIRE(areas[i] == Approx(fareas[i]));
+        }
+    }
+
+    SECTION("cotangent weights")
+    {
+        std::vector<double> cotangents;
+        Euclid::cotangent_weights(positions, indices, cotangents);
+        REQUIRE(cotangents.size() == nf * 3);
+        for (size_t i = 0; i < nf; ++i) {
+            Point_3 p[3];
+            for (int c = 0; c < 3; ++c) {
+                auto idx = 3 * indices[3 * i + c];
+                p[c] = Point_3(positions[idx + 0],
+                               positions[idx + 1],
+                               positions[idx + 2]);
+            }
+            for (int c = 0; c < 3; ++c) {
+                auto cot =
+                    Euclid::cotangent(p[(c + 1) % 3], p[c], p[(c + 2) % 3]);
+                REQUIRE(cotangents[3 * i + c] == Approx(cot).margin(1e-8));
+            }
+        }
+    }
+
+    SECTION("angle defects")
+    {
+        std::vector<double> defects;
+        Euclid::angle_defects(positions, indices, defects);
+        auto areas = Euclid::vertex_areas(bumpy);
+        auto curvatures = Euclid::gaussian_curvatures(bumpy);
+        REQUIRE(defects.size() == num_vertices(bumpy));
+        for (size_t i = 0; i < defects.size(); ++i) {
+            REQUIRE(defects[i] / areas[i] ==
+                    Approx(curvatures[i]).margin(1e-6));
+        }
+    }
+
+    SECTION("single precision")
+    {
+        std::vector<float> fpositions(positions.begin(), positions.end());
+        std::vector<float> fareas;
+        std::vector<double> dareas;
+        Euclid::face_areas(fpositions, indices, fareas);
+        Euclid::face_areas(positions, indices, dareas);
+        REQUIRE(fareas.size() == dareas.size());
+        for (size_t i = 0; i < nf; ++i) {
+            REQUIRE(fareas[i] == Approx(dareas[i]).epsilon(1e-4));
+        }
+    }
+}
+
+TEST_CASE("Geometry, TriMeshKernels benchmark",
+          "[.benchmark][geometry][trimeshkernels]")
+{
+    std::string fdragon(DATA_DIR);
+    fdragon.append("dragon.ply");
+    std::vector<double> positions;
+    std::vector<unsigned> indices;
+    Euclid::read_ply<3>(
+        fdragon, positions, nullptr, nullptr, &indices, nullptr);
+    std::vector<float> fpositions(positions.begin(), positions.end());
+    Mesh dragon;
+    Euclid::make_mesh<3>(dragon, positions, indices);
+
+    BENCHMARK("face normals, CGAL")
+    {
+        auto normals = Euclid::face_normals(dragon);
+    }
+
+    BENCHMARK("face normals, double")
+    {
+        std::vector<double> normals;
+        Euclid::face_normals(positions, indices, normals);
+    }
+
+    BENCHMARK("face normals, float")
+    {
+        std::vector<float> normals;
+        Euclid::face_normals(fpositions, indices, normals);
+    }
+
+    BENCHMARK("angle defects, CGAL")
+    {
+        std::vector<double> defects;
+        defects.reserve(num_vertices(dragon));
+        for (auto v : vertices(dragon)) {
+            defects.push_back(Euclid::gaussian_curvature(v, dragon) *
+                              Euclid::vertex_area(v, dragon));
+        }
+    }
+
+    BENCHMARK("angle defects, double")
+    {
+        std::vector<double> defects;
+        Euclid::angle_defects(positions, indices, defects);
+    }
+
+    BENCHMARK("angle defects, float")
+    {
+        std::vector<float> defects;
+        Euclid::angle_defects(fpositions, indices, defects);
+    }
+}
@@ -125,6 +125,13 @@ TEST_CASE("Util, Memory", "[util][memory]")
         p1 = std::move(p2);
         REQUIRE(p1);
         REQUIRE(!p2);
+
+        // move construct from existing
+        BPtr p3(std::move(p1));
+        REQUIRE(p3);
+        REQUIRE(p3.owns());
+        REQUIRE(!p1);
+        REQUIRE(!p1.owns());
     }
 
     SECTION("move from derived type")
@@ -140,6 +147,13 @@ TEST_CASE("Util, Memory", "[util][memory]")
         p1 = DPtr(new Derived(3), true);
         REQUIRE(p1->data == 3);
         REQUIRE(dynamic_cast<Derived*>(p1.get())->get() == 3);
+
+        auto p3 = DPtr(new Derived(4), true);
+        BPtr p4(std::move(p3));
+        REQUIRE(p4->data == 4);
+        REQUIRE(p4.owns());
+        REQUIRE(!p3);
+        REQUIRE(!p3.owns());
     }
 
     SECTION("release and reset")